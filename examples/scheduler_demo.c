@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/lexer.h"
+#include "../include/parser.h"
+#include "../include/typecheck.h"
+#include "../include/scheduler.h"
+
+/*
+ * Scheduler demo for the Mini C Compiler
+ *
+ * Submits many small scripts to the scheduler at once, some of which are meant to
+ * fail or to exceed their budgets, waits for all of them and prints their statistics.
+ * Every kind of script has an expected final state, so the demo also checks that a
+ * misbehaving script only stops itself.
+ *
+ * Build (from the project directory):
+ *   gcc examples/scheduler_demo.c src/lexer.c src/parser.c src/interpreter.c src/profiler.c src/scheduler.c src/typecheck.c -Iinclude -lpthread -o scheduler_demo
+ * Run:
+ *   ./scheduler_demo [scripts] [workers]
+ */
+
+// One kind of script: its source code, its budgets and the state it should end in
+typedef struct {
+    const char* label;
+    const char* source;
+    ScriptLimits limits;      // max steps, max memory (bytes), slice (0 = scheduler default)
+    ScriptState expected;
+    ASTNode* root;            // typed AST, shared by every script of this kind
+} ScriptKind;
+
+static ScriptKind kinds[] = {
+    { "arithmetic",       "let x = 5 + 3; let y = 1 + 1; print(x + y);",
+      { 0, 0, 0 },   SCRIPT_DONE,         NULL },
+    { "doubles",          "let r = 2.5 * 4; let m = r / 3; print(m);",
+      { 0, 0, 0 },   SCRIPT_DONE,         NULL },
+    { "division by zero", "let x = 1; print(x / 0);",
+      { 0, 0, 0 },   SCRIPT_FAILED,       NULL },
+    { "overflow",         "let m = 9223372036854775807; print(m + 1);",
+      { 0, 0, 0 },   SCRIPT_FAILED,       NULL },
+    { "step budget",      "let z = 1 + 2 + 3 + 4 + 5 + 6 + 7 + 8; print(z); print(z * z);",
+      { 10, 0, 2 },  SCRIPT_STEP_LIMIT,   NULL },
+    { "memory budget",    "let a = 1; let b = 2; let c = 3; let d = 4; let e = 5; let f = 6; print(a);",
+      { 0, 512, 0 }, SCRIPT_MEMORY_LIMIT, NULL },
+};
+
+#define KIND_COUNT ((int)(sizeof(kinds) / sizeof(kinds[0])))
+
+static const char* state_name(ScriptState state) {
+    switch (state) {
+        case SCRIPT_QUEUED:       return "queued";
+        case SCRIPT_RUNNING:      return "running";
+        case SCRIPT_DONE:         return "done";
+        case SCRIPT_FAILED:       return "failed";
+        case SCRIPT_STEP_LIMIT:   return "step limit";
+        case SCRIPT_MEMORY_LIMIT: return "memory limit";
+        default:                  return "?";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int script_count = argc > 1 ? atoi(argv[1]) : 1000;
+    int worker_count = argc > 2 ? atoi(argv[2]) : 4;
+    if (script_count <= 0 || worker_count <= 0) {
+        fprintf(stderr, "Example usage: %s [scripts] [workers]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Every kind is lexed, parsed and typed once; its AST is then shared by all its scripts
+    for (int k = 0; k < KIND_COUNT; k++) {
+        TokenList tokens = lex(kinds[k].source);
+        kinds[k].root = parse(&tokens);
+        infer_types(kinds[k].root, NULL);
+        free(tokens.tokens); // the AST keeps copies of everything it needs
+    }
+
+    // print() output of the scripts is not interesting here: send it to a temporary file
+    FILE* out = tmpfile();
+    if (!out) out = stdout;
+
+    Scheduler sched;
+    if (sched_init(&sched, worker_count, 3) != 0) {
+        fprintf(stderr, "Error: cannot start the scheduler\n");
+        return EXIT_FAILURE;
+    }
+
+    int* ids = malloc(script_count * sizeof(int));
+    if (!ids) {
+        fprintf(stderr, "Error: out of memory\n");
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < script_count; i++) {
+        ScriptKind* kind = &kinds[i % KIND_COUNT];
+        ids[i] = sched_submit(&sched, kind->root, &kind->limits, out);
+        if (ids[i] < 0) {
+            fprintf(stderr, "Error: cannot submit script %d\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    sched_wait(&sched);
+
+    // Print the statistics of the first script of every kind, then check all the others
+    printf("%-18s %-13s %6s %7s %8s  %s\n", "script", "state", "steps", "slices", "memory", "error");
+    int unexpected = 0;
+    for (int i = 0; i < script_count; i++) {
+        ScriptKind* kind = &kinds[i % KIND_COUNT];
+        ScriptStats stats;
+        if (sched_get_stats(&sched, ids[i], &stats) != 0) {
+            unexpected++;
+            continue;
+        }
+        if (i < KIND_COUNT)
+            printf("%-18s %-13s %6ld %7ld %8zu  %s\n", kind->label, state_name(stats.state),
+                   stats.steps, stats.slices, stats.peak_memory, stats.error);
+        if (stats.state != kind->expected) {
+            if (unexpected < 10)
+                printf("script %d (%s): expected %s, got %s\n", ids[i], kind->label,
+                       state_name(kind->expected), state_name(stats.state));
+            unexpected++;
+        }
+    }
+
+    printf("\n%d scripts on %d workers, %d with an unexpected final state\n", script_count, worker_count, unexpected);
+
+    sched_destroy(&sched);
+    free(ids);
+    if (out != stdout) fclose(out);
+    return unexpected == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
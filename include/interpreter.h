@@ -1,6 +1,8 @@
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
 
+#include <stdio.h>
+#include <stddef.h>
 #include "parser.h"
 
 /*
@@ -14,25 +16,120 @@
  */
 
 // Represents a single entry (a variable) in the symbol table
-// Each Symbol is a name–value pair (like x = 5)
+// Each Symbol is a name–value pair (like x = 5) together with the variable's type
 typedef struct {
-    char name[32];  // variable name
-    int value;      // variable value
+    char name[32];   // variable name
+    ValueType type;  // variable type (int or double)
+    Value value;     // variable value
 } Symbol;
 
 // Represents the entire symbol table
+// It has two layers: the program's own variables, and an optional read-only base
+// layer mapped from a snapshot (see snapshot.h). A variable of the base layer that the
+// program assigns is copied into the program's own layer, which is searched first.
+// Both layers have a hash index of the same kind, so lookups do not depend on the number of variables.
 typedef struct {
-    Symbol symbols[128]; // fixed-size array of symbols (max 128 variables)
+    Symbol* symbols;     // array of the program's own symbols, grows when full
     int count;           // number of symbols currently stored in the table; also indicates the next free position in 'symbols'
+    int capacity;        // number of symbols that fit in 'symbols'
+    unsigned int* index;       // hash index of 'symbols': each slot holds a symbol number + 1 (0 = empty)
+    unsigned int index_size;   // number of slots in 'index' (a power of two, twice 'capacity')
+
+    const Symbol* base;              // read-only symbols of a snapshot (NULL if none)
+    int base_count;                  // number of symbols in 'base'
+    const unsigned int* base_index;  // hash index of 'base': each slot holds a symbol number + 1 (0 = empty)
+    unsigned int base_index_size;    // number of slots in 'base_index' (a power of two)
 } SymbolTable;
 
+/*
+ * Resumable execution
+ *
+ * Instead of walking the AST with recursive C calls, the interpreter keeps its own
+ * explicit stacks inside an ExecContext. This lets execution stop after a given
+ * number of steps and continue later exactly where it left off.
+ * One "step" is one visit of an AST node (or the completion of a statement).
+ */
+
+// Status of an execution context
+typedef enum {
+    EXEC_READY,         // initialized, nothing executed yet
+    EXEC_YIELDED,       // step budget exhausted, can be resumed with exec_run()
+    EXEC_DONE,          // all statements executed
+    EXEC_ERROR,         // runtime error (see 'error')
+    EXEC_OUT_OF_MEMORY  // memory budget exceeded (see 'error')
+} ExecStatus;
+
+// One pending expression node on the evaluation stack
+typedef struct {
+    ASTNode* node;  // node being evaluated
+    int stage;      // 0 = not started, 1 = left operand done, 2 = both operands done
+} EvalFrame;
+
+struct Profiler; // see profiler.h
+
+// Complete state of one (possibly suspended) program execution
+typedef struct {
+    ASTNode* current;      // statement being executed (or the next one to start)
+    int in_statement;      // 1 if 'current' has been started but not finished
+    SymbolTable* table;    // variable storage (not owned by the context)
+    FILE* out;             // where print() writes its output
+
+    EvalFrame* frames;     // explicit evaluation stack (replaces C recursion)
+    int frame_count;
+    int frame_capacity;
+    Value* values;         // intermediate results of evaluated sub-expressions (untagged: node types say how to read them)
+    int value_count;
+    int value_capacity;
+
+    long steps;            // total number of steps executed so far
+    size_t memory_limit;   // max bytes for stacks + symbols (0 = unlimited)
+    struct Profiler* profiler; // if not NULL, receives evaluation counts and time samples
+    ExecStatus status;
+    char error[128];       // error message when status is EXEC_ERROR / EXEC_OUT_OF_MEMORY
+} ExecContext;
+
 /* Function prototypes */
 void init_symbol_table(SymbolTable* table);
-int lookup_symbol(SymbolTable* table, const char* name);
-void set_symbol(SymbolTable* table, const char* name, int value);
+void free_symbol_table(SymbolTable* table);
+unsigned int symbol_hash(const char* name);
+const Symbol* find_base_symbol(const SymbolTable* table, const char* name);
+const Symbol* find_symbol_entry(const SymbolTable* table, const char* name);
+int find_symbol(SymbolTable* table, const char* name, Value* value);
+Value lookup_symbol(SymbolTable* table, const char* name);
+int try_set_symbol(SymbolTable* table, const char* name, ValueType type, Value value);
+void set_symbol(SymbolTable* table, const char* name, ValueType type, Value value);
 
-int eval_expression(ASTNode* node, SymbolTable* table);
+/*
+ *   Prepares 'ctx' to execute the statement list starting at 'root' using 'table' for variables.
+ *   Output of print() goes to 'out' (stdout if NULL).
+ */
+void exec_init(ExecContext* ctx, ASTNode* root, SymbolTable* table, FILE* out);
+
+/*
+ *   Runs at most 'max_steps' steps (0 = run to completion) and returns the new status.
+ *   Calling it again on an EXEC_YIELDED context continues from the saved state.
+ *   Runtime errors never terminate the process: they are reported through the status and 'error'.
+ */
+ExecStatus exec_run(ExecContext* ctx, long max_steps);
+
+/*
+ *   Returns the number of bytes currently used by the context (stacks + symbol table entries).
+ */
+size_t exec_memory_usage(const ExecContext* ctx);
+
+/*
+ *   Releases the evaluation stacks of the context (the symbol table is not touched).
+ */
+void exec_free(ExecContext* ctx);
+
+Value eval_expression(ASTNode* node, SymbolTable* table);
 void exec_statement(ASTNode* node, SymbolTable* table);
 void interpret(ASTNode* root);
 
-#endif
\ No newline at end of file
+/*
+ *   Runs the program to completion using 'table' for variables, optionally profiling it.
+ *   Like interpret(), a runtime error prints a message and terminates the program.
+ */
+void interpret_program(ASTNode* root, SymbolTable* table, struct Profiler* profiler);
+
+#endif
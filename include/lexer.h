@@ -1,12 +1,15 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include "value.h"
+
 /*
  * Token types for the Mini C Compiler
  * Each token represents a meaningful element of the source code
  */
 typedef enum {
-    T_NUMBER,      // numeric literal
+    T_NUMBER,      // integer literal (64-bit)
+    T_FLOAT,       // floating-point literal (e.g. 2.5)
     T_PLUS,        // '+'
     T_MINUS,       // '-'
     T_MULT,        // '*'
@@ -14,6 +17,7 @@ typedef enum {
     T_LET,         // 'let' keyword
     T_IDENTIFIER,  // variable name
     T_EQUAL,       // '='
+    T_COLON,       // ':' (type annotation, e.g. let x: double = 1;)
     T_PRINT,       // 'print' keyword
     T_SEMICOLON,   // ';'
     T_LPAREN,   // '('
@@ -27,8 +31,11 @@ typedef enum {
  */
 typedef struct {
     TokenType type;
-    int value;         // used if token is a number
+    long long value;   // used if token is an integer number
+    double fvalue;     // used if token is a floating-point number
     char name[32];     // used if token is a variable
+    int line;          // line where the token starts (1-based)
+    int column;        // column where the token starts (1-based)
 } Token;
 
 /*
@@ -38,6 +45,7 @@ typedef struct {
 typedef struct {
     Token* tokens;
     int count;
+    int capacity;      // number of tokens that fit in 'tokens' before it must grow
 } TokenList;
 
 /* Function declarations */
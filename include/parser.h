@@ -1,6 +1,7 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <stddef.h>
 #include "lexer.h"
 
 /*
@@ -12,7 +13,8 @@ typedef enum {
     AST_BINARY_OP,    // binary operation (+, -, *, /)
     AST_VAR,      // variable usage
     AST_ASSIGN,   // variable assignment
-    AST_PRINT     // print statement
+    AST_PRINT,    // print statement
+    AST_CAST      // conversion of the left child to 'vtype' (annotations and mixed int/double operations)
 } ASTNodeType;
 
 /*
@@ -21,10 +23,15 @@ typedef enum {
  */
 typedef struct ASTNode {
     ASTNodeType type;        // node type
-    int value;               // used if node is a number
+    ValueType vtype;         // static type of the node's result (set by the parser for literals, by infer_types() otherwise)
+    int typed;               // 1 once infer_types() has visited the node (the interpreter refuses untyped programs)
+    long long value;         // used if node is an integer number (or holds the operator of a binary operation)
+    double fvalue;           // used if node is a floating-point number
     char name[32];           // used if node is a variable
     struct ASTNode* left;    // left child (for binary operations)
     struct ASTNode* right;   // right child (for binary operations)
+    int line;                // source line of the token that produced the node
+    int column;              // source column of the token that produced the node
 } ASTNode;
 
 /* Function declarations */
@@ -49,5 +56,16 @@ ASTNode* parse(TokenList* tokens);
  */
 void print_ast(ASTNode* node, int indent);
 
+/*
+ *   Name of a value type as written in source code ("int", "double"), taken from VALUE_TYPES.
+ */
+const char* value_type_name(ValueType type);
+
+/*
+ *   Writes the value of the literal 'node' (an AST_NUMBER) into 'buffer', using the
+ *   printf format of its type from VALUE_TYPES. Returns the result of snprintf().
+ */
+int format_literal(char* buffer, size_t size, const ASTNode* node);
+
 
 #endif
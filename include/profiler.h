@@ -0,0 +1,85 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdio.h>
+#include "interpreter.h"
+
+/*
+ * Source-level profiler for the Mini C Compiler
+ *
+ * While a program runs, the interpreter reports to the profiler:
+ * - every statement it starts and every AST node it evaluates (exact counts)
+ * - every 'sample_interval' steps, the current evaluation stack (sampled time)
+ *
+ * Time measured between two samples is attributed to the statement being executed
+ * and to every node on the evaluation stack, so nested expressions show up as
+ * nested frames in a flamegraph.
+ */
+
+// Counters collected for one statement or one AST node
+typedef struct {
+    ASTNode* node;          // profiled node (NULL = empty slot in the hash table)
+    long evaluations;       // how many times it was executed / evaluated
+    long long self_ns;      // sampled time while the node was at the top of the stack
+    long long total_ns;     // sampled time while the node was anywhere on the stack
+} NodeProfile;
+
+// Hash table of NodeProfile entries, keyed by node address
+typedef struct {
+    NodeProfile* entries;
+    int count;
+    int capacity;           // always a power of two
+} ProfileTable;
+
+// One distinct call stack and the time sampled in it (folded-stack format)
+typedef struct {
+    char* stack;            // frames separated by ';' (NULL = empty slot)
+    long long ns;
+} FoldedStack;
+
+typedef struct Profiler {
+    ProfileTable statements;  // one entry per statement
+    ProfileTable nodes;       // one entry per evaluated expression node
+
+    FoldedStack* stacks;      // hash table of distinct stacks, keyed by the stack string
+    int stack_count;
+    int stack_capacity;
+    char* scratch;            // buffer used to build the stack string of a sample
+    size_t scratch_size;
+
+    long sample_interval;     // steps between two time samples
+    long countdown;           // steps left before the next sample
+    long long last_sample_ns; // clock value at the previous sample
+    long long sampled_ns;     // total time attributed so far
+} Profiler;
+
+/*
+ *   Prepares an empty profiler that samples the clock every 'sample_interval' steps.
+ */
+void profiler_init(Profiler* profiler, long sample_interval);
+
+/*
+ *   Counts one execution of a statement / one evaluation of an expression node.
+ */
+void profiler_count_statement(Profiler* profiler, ASTNode* statement);
+void profiler_count_node(Profiler* profiler, ASTNode* node);
+
+/*
+ *   Called by the interpreter after every step; takes a time sample when the countdown expires.
+ */
+void profiler_tick(Profiler* profiler, const ExecContext* ctx);
+
+/*
+ *   Prints the statements (and nodes) that used the most time, hottest first.
+ */
+void profiler_report(Profiler* profiler, FILE* out);
+
+/*
+ *   Writes the sampled stacks in folded format ("frame;frame;frame nanoseconds" per line),
+ *   which flamegraph tools such as flamegraph.pl or speedscope can read.
+ */
+void profiler_write_folded(Profiler* profiler, FILE* out);
+
+void profiler_free(Profiler* profiler);
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "interpreter.h"
+
+/*
+ * Cooperative scheduler for the Mini C Compiler
+ *
+ * Runs many programs (scripts) concurrently on a fixed set of worker threads.
+ * Each script is an ExecContext that runs for a small number of steps (a time slice),
+ * then goes back to the end of the run queue so that the other scripts can progress.
+ * A long script therefore cannot starve the others, and a script that exceeds its
+ * budgets or hits a runtime error is stopped without affecting the host process.
+ */
+
+// Per-script budgets (0 = unlimited)
+typedef struct {
+    long max_steps;       // total number of steps the script may execute
+    size_t max_memory;    // max bytes of interpreter memory (stacks + symbols)
+    long slice_steps;     // steps per time slice (0 = scheduler default)
+} ScriptLimits;
+
+// Life cycle of a script inside the scheduler
+typedef enum {
+    SCRIPT_QUEUED,        // waiting in the run queue
+    SCRIPT_RUNNING,       // currently executing on a worker
+    SCRIPT_DONE,          // finished successfully
+    SCRIPT_FAILED,        // stopped by a runtime error
+    SCRIPT_STEP_LIMIT,    // stopped because it used its whole step budget
+    SCRIPT_MEMORY_LIMIT   // stopped because it exceeded its memory budget
+} ScriptState;
+
+// Statistics of a single script
+typedef struct {
+    int id;               // identifier returned by sched_submit()
+    ScriptState state;
+    long steps;           // steps executed so far (the script's "CPU" usage)
+    long slices;          // number of time slices received
+    size_t peak_memory;   // highest memory usage observed at the end of a slice
+    char error[128];      // error message for SCRIPT_FAILED / SCRIPT_MEMORY_LIMIT
+} ScriptStats;
+
+// A script managed by the scheduler
+typedef struct Script {
+    ExecContext ctx;      // saved execution state
+    SymbolTable table;    // private variables of the script
+    ScriptLimits limits;
+    ScriptStats stats;
+    struct Script* next;  // next script in the run queue
+} Script;
+
+// The scheduler itself
+typedef struct {
+    pthread_t* workers;
+    int worker_count;
+    long default_slice;       // steps per time slice when a script does not specify one
+
+    pthread_mutex_t lock;     // protects every field below
+    pthread_cond_t work_ready;
+    pthread_cond_t all_done;
+    Script* queue_head;       // run queue (FIFO)
+    Script* queue_tail;
+    Script** scripts;         // all submitted scripts, indexed by id
+    int script_count;
+    int script_capacity;
+    int unfinished;           // scripts not yet finished
+    int shutting_down;
+} Scheduler;
+
+/*
+ *   Starts 'worker_count' worker threads. 'default_slice' is the number of steps a script
+ *   runs before yielding to the next one. Returns 0 on success, -1 on failure.
+ */
+int sched_init(Scheduler* sched, int worker_count, long default_slice);
+
+/*
+ *   Adds the program 'root' to the run queue. print() output goes to 'out' (stdout if NULL).
+ *   'limits' may be NULL for no budgets. Returns the script id, or -1 on failure.
+ *   The AST must already have been through infer_types() (an untyped AST is rejected)
+ *   and must stay valid until the script has finished. The same AST may be submitted many times.
+ */
+int sched_submit(Scheduler* sched, ASTNode* root, const ScriptLimits* limits, FILE* out);
+
+/*
+ *   Blocks until every submitted script has finished.
+ */
+void sched_wait(Scheduler* sched);
+
+/*
+ *   Copies the statistics of script 'id' into 'stats'. Returns 0 on success, -1 if the id is unknown.
+ */
+int sched_get_stats(Scheduler* sched, int id, ScriptStats* stats);
+
+/*
+ *   Stops the worker threads and frees every script. Scripts still queued are not executed.
+ */
+void sched_destroy(Scheduler* sched);
+
+#endif
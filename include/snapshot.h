@@ -0,0 +1,54 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include "interpreter.h"
+
+/*
+ * Symbol table snapshots for the Mini C Compiler
+ *
+ * A program (typically a prelude of 'let' constants) is evaluated once and the
+ * resulting variables are saved to a file. Later runs map that file into memory
+ * and use it directly as the read-only base layer of their SymbolTable, skipping
+ * lexing, parsing and evaluation of the prelude.
+ *
+ * File layout:
+ *   SnapshotHeader
+ *   Symbol[count]                    (exactly the in-memory layout of the symbols)
+ *   unsigned int index[index_size]   (hash index: symbol number + 1, 0 = empty slot)
+ */
+
+#define SNAPSHOT_MAGIC "MCSNAP1"   // 7 characters + '\0'
+#define SNAPSHOT_VERSION 3   // 2: symbols carry a type and a 64-bit Value, 3: hash index
+
+typedef struct {
+    char magic[8];             // SNAPSHOT_MAGIC
+    unsigned int version;      // SNAPSHOT_VERSION
+    unsigned int symbol_size;  // sizeof(Symbol) of the program that wrote the file
+    unsigned int count;        // number of symbols that follow the header
+    unsigned int index_size;   // number of slots of the hash index (a power of two)
+} SnapshotHeader;
+
+// A snapshot file mapped into memory
+typedef struct {
+    void* data;     // start of the mapping (NULL if nothing is loaded)
+    size_t size;    // size of the mapping in bytes
+} Snapshot;
+
+/*
+ *   Writes every variable of 'table' (both layers) to the file 'path'.
+ *   Returns the number of variables written, or -1 on failure (an error message is printed).
+ */
+int snapshot_save(const char* path, const SymbolTable* table);
+
+/*
+ *   Maps the file 'path' into memory and initializes 'table' with the stored symbols as its
+ *   read-only base layer (no copy is made). 'snapshot' keeps the mapping alive and must
+ *   be closed with snapshot_close() after the table is no longer used.
+ *   Returns 0 on success, -1 on failure (an error message is printed).
+ */
+int snapshot_load(const char* path, Snapshot* snapshot, SymbolTable* table);
+
+void snapshot_close(Snapshot* snapshot);
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef TYPECHECK_H
+#define TYPECHECK_H
+
+#include "parser.h"
+#include "interpreter.h"
+
+/*
+ * Type inference for the Mini C Compiler
+ *
+ * Runs after parse() and before the interpreter. It gives every node of the AST
+ * its static type ('vtype'):
+ * - integer literals are int (64-bit), literals with a '.' are double
+ * - a variable has the type of the value it is first assigned (or of its annotation)
+ * - a binary operation on two ints is int; as soon as one side is double it is double
+ *
+ * Where int and double meet, the int side is wrapped in an AST_CAST node, so the
+ * interpreter never has to check types at runtime. Later assignments to a variable
+ * are converted to the variable's type, as in C.
+ */
+
+/*
+ *   Infers the types of the whole program 'root'.
+ *   'initial' gives the types of variables that exist before the program starts
+ *   (e.g. loaded from a snapshot); it may be NULL.
+ */
+void infer_types(ASTNode* root, const SymbolTable* initial);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef VALUE_H
+#define VALUE_H
+
+/*
+ * Value types of the Mini C language
+ *
+ * Every type is described once in VALUE_TYPES; the enum below, the typed
+ * evaluation code of the interpreter, the type names of annotations and the
+ * printing of values and literals are all generated from this list, so adding
+ * a type means adding one line here (plus its conversions in AST_CAST).
+ *
+ * X(tag, C type, Value field, ASTNode literal field, printf format, name in source code, arithmetic)
+ *
+ * 'arithmetic' is CHECKED for types whose + - * / can overflow (the interpreter then
+ * reports an error instead of running into undefined behaviour) and UNCHECKED otherwise.
+ */
+#define VALUE_TYPES(X) \
+    X(TYPE_INT,    long long, i, value,  "%lld",  "int",    CHECKED)   \
+    X(TYPE_DOUBLE, double,    d, fvalue, "%.15g", "double", UNCHECKED)
+
+// Static type of a literal, variable or expression
+typedef enum {
+#define X(tag, ctype, field, literal, format, type_name, arithmetic) tag,
+    VALUE_TYPES(X)
+#undef X
+    VALUE_TYPE_COUNT
+} ValueType;
+
+/*
+ * A runtime value. It carries no type tag: the type of every expression is known
+ * before execution (see typecheck.h), so the interpreter always knows which field to read.
+ */
+typedef union {
+    long long i;   // TYPE_INT (64-bit integer)
+    double d;      // TYPE_DOUBLE
+} Value;
+
+#endif
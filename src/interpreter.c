@@ -1,13 +1,112 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "../include/interpreter.h"
+#include "../include/profiler.h"
+#include "../include/typecheck.h"
 
 /*
  * Initializes the symbol table by setting count = 0
+ * The array of symbols is only allocated when the first variable is stored.
  */
 void init_symbol_table(SymbolTable* table) {
+    table->symbols = NULL;
     table->count = 0;
+    table->capacity = 0;
+    table->index = NULL;
+    table->index_size = 0;
+    table->base = NULL;
+    table->base_count = 0;
+    table->base_index = NULL;
+    table->base_index_size = 0;
+}
+
+/*
+ * Releases the memory of the symbol table (the base layer belongs to its snapshot and is not freed here)
+ */
+void free_symbol_table(SymbolTable* table) {
+    free(table->symbols);
+    free(table->index);
+    init_symbol_table(table);
+}
+
+/*
+ * FNV-1a hash of a variable name, used by the indexes of both layers
+ * (snapshot files store that index, so the function must never change)
+ */
+unsigned int symbol_hash(const char* name) {
+    unsigned int hash = 2166136261u;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/*
+ * Looks up a variable in the read-only base layer only, using its hash index.
+ * Returns NULL if the table has no base layer or the variable is not in it.
+ *
+ * The base layer comes straight from a snapshot file, which is not checked as a whole
+ * when it is loaded (that would make start-up cost grow with the prelude again).
+ * Only what a lookup touches is checked: slots must point inside 'base', probing stops
+ * after visiting every slot once, and a compared name must be NUL-terminated.
+ * A symbol with an unknown type is treated as missing.
+ */
+const Symbol* find_base_symbol(const SymbolTable* table, const char* name) {
+    if (table->base_index == NULL) return NULL;
+
+    unsigned int mask = table->base_index_size - 1;
+    unsigned int slot = symbol_hash(name) & mask;
+    for (unsigned int probes = 0; probes < table->base_index_size && table->base_index[slot] != 0; probes++) {
+        unsigned int number = table->base_index[slot];
+        if (number > (unsigned int)table->base_count) return NULL; // corrupted index
+        const Symbol* symbol = &table->base[number - 1];
+        if (memchr(symbol->name, '\0', sizeof(symbol->name)) != NULL && strcmp(symbol->name, name) == 0)
+            return (unsigned int)symbol->type < VALUE_TYPE_COUNT ? symbol : NULL;
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+/*
+ * Looks up a variable in the program's own layer only, using its hash index.
+ * Returns NULL if the variable is not in it.
+ */
+static Symbol* find_own_symbol(const SymbolTable* table, const char* name) {
+    if (table->index == NULL) return NULL;
+
+    unsigned int mask = table->index_size - 1;
+    unsigned int slot = symbol_hash(name) & mask;
+    while (table->index[slot] != 0) {
+        Symbol* symbol = &table->symbols[table->index[slot] - 1];
+        if (strcmp(symbol->name, name) == 0) return symbol;
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+/*
+ * Looks up a variable in both layers: the program's own variables first, then the base layer.
+ * Returns NULL if the variable does not exist.
+ */
+const Symbol* find_symbol_entry(const SymbolTable* table, const char* name) {
+    const Symbol* symbol = find_own_symbol(table, name);
+    return symbol != NULL ? symbol : find_base_symbol(table, name);
+}
+
+/*
+ * Looks up a variable in the symbol table without failing.
+ * If found, stores its value in *value and returns 1; otherwise returns 0.
+ */
+int find_symbol(SymbolTable* table, const char* name, Value* value) {
+    const Symbol* symbol = find_symbol_entry(table, name);
+    if (symbol != NULL) {
+        *value = symbol->value;
+        return 1;
+    }
+    return 0;
 }
 
 /*
@@ -15,139 +114,491 @@ void init_symbol_table(SymbolTable* table) {
  * If found, returns its value.
  * If not found, prints an error and exits.
  */
-int lookup_symbol(SymbolTable* table, const char* name) {
-    for (int i = 0; i < table->count; i++) {
-        if (strcmp(table->symbols[i].name, name) == 0) {
-            return table->symbols[i].value;
-        }
+Value lookup_symbol(SymbolTable* table, const char* name) {
+    Value value;
+    if (find_symbol(table, name, &value)) {
+        return value;
     }
     printf("Runtime error: undefined variable '%s'\n", name);
     exit(1);
 }
 
+// Adds symbol number 'i' of the program's own layer to its hash index
+static void index_own_symbol(SymbolTable* table, int i) {
+    unsigned int mask = table->index_size - 1;
+    unsigned int slot = symbol_hash(table->symbols[i].name) & mask;
+    while (table->index[slot] != 0) slot = (slot + 1) & mask;
+    table->index[slot] = (unsigned int)i + 1;
+}
+
+/*
+ * Inserts or updates a variable in the symbol table without failing.
+ * Only the program's own layer is ever written: assigning a variable of the base
+ * layer adds a copy that hides it, so the snapshot itself is never modified or copied.
+ * When the array is full it doubles in size and its index is rebuilt with twice as
+ * many slots, so the index is never more than half full.
+ * Returns 1 on success, 0 if memory cannot be allocated.
+ */
+int try_set_symbol(SymbolTable* table, const char* name, ValueType type, Value value) {
+    Symbol* existing = find_own_symbol(table, name);
+    if (existing != NULL) {
+        existing->type = type;
+        existing->value = value;
+        return 1;
+    }
+    if (table->count == table->capacity) {
+        int capacity = table->capacity ? table->capacity * 2 : 16;
+        Symbol* symbols = realloc(table->symbols, capacity * sizeof(Symbol));
+        if (!symbols) return 0;
+        table->symbols = symbols;
+        unsigned int* index = calloc((size_t)capacity * 2, sizeof(unsigned int));
+        if (!index) return 0;
+        free(table->index);
+        table->index = index;
+        table->index_size = (unsigned int)capacity * 2;
+        table->capacity = capacity;
+        for (int i = 0; i < table->count; i++) index_own_symbol(table, i);
+    }
+    strncpy(table->symbols[table->count].name, name, 31);
+    table->symbols[table->count].name[31] = '\0';
+    table->symbols[table->count].type = type;
+    table->symbols[table->count].value = value;
+    index_own_symbol(table, table->count);
+    table->count++;
+    return 1;
+}
+
 /*
  * Inserts or updates a variable in the symbol table.
  * If variable already exists, updates its value.
  * If new, adds it to the table.
  */
-void set_symbol(SymbolTable* table, const char* name, int value) {
-    for (int i = 0; i < table->count; i++) {
-        if (strcmp(table->symbols[i].name, name) == 0) {
-            table->symbols[i].value = value;
-            return;
+void set_symbol(SymbolTable* table, const char* name, ValueType type, Value value) {
+    if (!try_set_symbol(table, name, type, value)) {
+        printf("Runtime error: out of memory for variable '%s'\n", name);
+        exit(1);
+    }
+}
+
+/*
+ * Stops the execution with a runtime error.
+ * The message is stored in the context instead of terminating the process.
+ */
+static void exec_fail(ExecContext* ctx, ExecStatus status, const char* message) {
+    ctx->status = status;
+    strncpy(ctx->error, message, sizeof(ctx->error) - 1);
+    ctx->error[sizeof(ctx->error) - 1] = '\0';
+}
+
+// Same as exec_fail(), adding the source position of the node that caused the error
+static void exec_fail_at(ExecContext* ctx, ASTNode* node, const char* message) {
+    char located[sizeof(ctx->error)];
+    snprintf(located, sizeof(located), "%s at line %d, column %d", message, node->line, node->column);
+    exec_fail(ctx, EXEC_ERROR, located);
+}
+
+size_t exec_memory_usage(const ExecContext* ctx) {
+    return (size_t)ctx->frame_capacity * sizeof(EvalFrame)
+         + (size_t)ctx->value_capacity * sizeof(Value)
+         + (size_t)ctx->table->count * sizeof(Symbol);
+}
+
+/*
+ * Makes sure there is room for one more frame and one more value.
+ * The stacks double in size when full; growing past the memory budget is an error.
+ */
+static int exec_reserve(ExecContext* ctx) {
+    if (ctx->frame_count < ctx->frame_capacity && ctx->value_count < ctx->value_capacity)
+        return 1;
+
+    int frame_capacity = ctx->frame_capacity;
+    int value_capacity = ctx->value_capacity;
+    if (ctx->frame_count >= frame_capacity) frame_capacity = frame_capacity ? frame_capacity * 2 : 16;
+    if (ctx->value_count >= value_capacity) value_capacity = value_capacity ? value_capacity * 2 : 16;
+
+    size_t needed = (size_t)frame_capacity * sizeof(EvalFrame)
+                  + (size_t)value_capacity * sizeof(Value)
+                  + (size_t)ctx->table->count * sizeof(Symbol);
+    if (ctx->memory_limit != 0 && needed > ctx->memory_limit) {
+        exec_fail(ctx, EXEC_OUT_OF_MEMORY, "memory budget exceeded");
+        return 0;
+    }
+
+    if (frame_capacity != ctx->frame_capacity) {
+        EvalFrame* frames = realloc(ctx->frames, frame_capacity * sizeof(EvalFrame));
+        if (!frames) {
+            exec_fail(ctx, EXEC_OUT_OF_MEMORY, "out of memory");
+            return 0;
         }
+        ctx->frames = frames;
+        ctx->frame_capacity = frame_capacity;
     }
-    if (table->count < 128) {
-        strncpy(table->symbols[table->count].name, name, 31);
-        table->symbols[table->count].name[31] = '\0';
-        table->symbols[table->count].value = value;
-        table->count++;
-    } else {
-        printf("Runtime error: symbol table overflow\n");
-        exit(1);
+    if (value_capacity != ctx->value_capacity) {
+        Value* values = realloc(ctx->values, value_capacity * sizeof(Value));
+        if (!values) {
+            exec_fail(ctx, EXEC_OUT_OF_MEMORY, "out of memory");
+            return 0;
+        }
+        ctx->values = values;
+        ctx->value_capacity = value_capacity;
     }
+    return 1;
+}
+
+// Pushes a node on the evaluation stack (it will be evaluated by the next steps)
+static int push_frame(ExecContext* ctx, ASTNode* node) {
+    if (!exec_reserve(ctx)) return 0;
+    ctx->frames[ctx->frame_count].node = node;
+    ctx->frames[ctx->frame_count].stage = 0;
+    ctx->frame_count++;
+    return 1;
+}
+
+// Pushes the result of an evaluated node and removes its frame
+static void finish_frame(ExecContext* ctx, Value value) {
+    ctx->frame_count--;
+    ctx->values[ctx->value_count++] = value;
 }
 
+void exec_init(ExecContext* ctx, ASTNode* root, SymbolTable* table, FILE* out) {
+    ctx->current = root;
+    ctx->in_statement = 0;
+    ctx->table = table;
+    ctx->out = out ? out : stdout;
+    ctx->frames = NULL;
+    ctx->frame_count = 0;
+    ctx->frame_capacity = 0;
+    ctx->values = NULL;
+    ctx->value_count = 0;
+    ctx->value_capacity = 0;
+    ctx->steps = 0;
+    ctx->memory_limit = 0;
+    ctx->profiler = NULL;
+    ctx->status = EXEC_READY;
+    ctx->error[0] = '\0';
+
+    // Without infer_types() every 'vtype' is a guess and values would be read from the wrong field
+    if (root != NULL && !root->typed)
+        exec_fail(ctx, EXEC_ERROR, "program has not been type-checked (call infer_types() first)");
+}
+
+void exec_free(ExecContext* ctx) {
+    free(ctx->frames);
+    free(ctx->values);
+    ctx->frames = NULL;
+    ctx->values = NULL;
+    ctx->frame_count = ctx->frame_capacity = 0;
+    ctx->value_count = ctx->value_capacity = 0;
+}
+
+// Index of the specialized evaluation code for a node type and a result type
+#define EVAL_KIND(node_type, value_type) ((node_type) * VALUE_TYPE_COUNT + (value_type))
+
 /*
- * Recursively evaluates an expression node
+ * Evaluation code for one value type, instantiated below for every entry of VALUE_TYPES.
+ * Inside one instance all operands and results have the same C type ('ctype'), so an
+ * all-int program only ever runs plain 64-bit integer code: values are never tagged,
+ * checked or converted. Conversions only happen in AST_CAST nodes, which infer_types()
+ * inserts where int and double are mixed.
  */
-int eval_expression(ASTNode* node, SymbolTable* table) {
-    switch (node->type) {
-        // --- Case 1: Number ---
-        case AST_NUMBER:
-            // If the node represents a number, simply return its value
-            // Example: AST_NUMBER(5)  => returns 5
-            return node->value;
+/*
+ * Arithmetic of the two kinds of types ('arithmetic' column of VALUE_TYPES).
+ * Each operation stores its result in *r and evaluates to nonzero on overflow.
+ * CHECKED: 64-bit integers, where overflow (and LLONG_MIN / -1, which traps on
+ * most CPUs) would be undefined behaviour, so it is detected and reported.
+ * UNCHECKED: doubles, which simply become inf or nan.
+ */
+#define CHECKED_ADD(a, b, r) __builtin_add_overflow((a), (b), (r))
+#define CHECKED_SUB(a, b, r) __builtin_sub_overflow((a), (b), (r))
+#define CHECKED_MUL(a, b, r) __builtin_mul_overflow((a), (b), (r))
+#define CHECKED_DIV_OVERFLOWS(a, b) ((b) == -1 && (a) == LLONG_MIN)
+#define UNCHECKED_ADD(a, b, r) (*(r) = (a) + (b), 0)
+#define UNCHECKED_SUB(a, b, r) (*(r) = (a) - (b), 0)
+#define UNCHECKED_MUL(a, b, r) (*(r) = (a) * (b), 0)
+#define UNCHECKED_DIV_OVERFLOWS(a, b) 0
 
-        // --- Case 2: Variable ---
-        case AST_VAR:
-            // If the node represents a variable, look up its value in the symbol table
-            // Example: AST_VAR("x") with table containing x = 10 => returns 10
-            return lookup_symbol(table, node->name);
-
-        // --- Case 3: Binary operation (+, -, *, /) ---
-        case AST_BINARY_OP: {
-            // Recursively evaluate the left-hand side of the binary operation.
-            // Example: if the expression is "5 + 3", node->left points to AST_NUMBER(5),
-            // so this call returns 5 and stores it in left_val.
-            int left_val = eval_expression(node->left, table);
-
-            // Recursively evaluate the right-hand side of the binary operation.
-            // Continuing the example: node->right points to AST_NUMBER(3),
-            // so this call returns 3 and stores it in right_val.
-            int right_val = eval_expression(node->right, table);
-
-            // Perform the operation indicated by node->value
-            switch (node->value) {
-                case '+': return left_val + right_val;
-                case '-': return left_val - right_val;
-                case '*': return left_val * right_val;
-                case '/':
-                    if (right_val == 0) { // protect against division by zero
-                        printf("Runtime error: division by zero\n");
-                        exit(1);
-                    }
-                    return left_val / right_val; // integer division
-                default:
-                    printf("Runtime error: unknown operator '%c'\n", node->value);
-                    exit(1);
+#define EVAL_CASES(tag, ctype, field, literal, format, type_name, arithmetic)             \
+    /* --- Case 1: Number --- */                                                         \
+    case EVAL_KIND(AST_NUMBER, tag): {                                                   \
+        /* If the node represents a number, its result is simply its value */            \
+        Value result;                                                                    \
+        result.field = node->literal;                                                    \
+        finish_frame(ctx, result);                                                       \
+        return;                                                                          \
+    }                                                                                    \
+    /* --- Case 2: Variable --- */                                                       \
+    case EVAL_KIND(AST_VAR, tag): {                                                      \
+        /* If the node represents a variable, look up its value in the symbol table */    \
+        const Symbol* symbol = find_symbol_entry(ctx->table, node->name);                \
+        if (symbol == NULL) {                                                            \
+            char message[96];                                                            \
+            snprintf(message, sizeof(message), "undefined variable '%s'", node->name);   \
+            exec_fail_at(ctx, node, message);                                            \
+            return;                                                                      \
+        }                                                                                \
+        /* The AST may have been typed against another table (e.g. another snapshot) */   \
+        if (symbol->type != tag) {                                                       \
+            char message[96];                                                            \
+            snprintf(message, sizeof(message), "variable '%s' no longer has type " type_name, node->name); \
+            exec_fail_at(ctx, node, message);                                            \
+            return;                                                                      \
+        }                                                                                \
+        finish_frame(ctx, symbol->value);                                                \
+        return;                                                                          \
+    }                                                                                    \
+    /* --- Case 3: Binary operation (+, -, *, /) --- */                                  \
+    case EVAL_KIND(AST_BINARY_OP, tag): {                                                \
+        /* Stage 0 schedules the left operand, stage 1 the right operand */              \
+        if (frame->stage < 2) {                                                          \
+            frame->stage++;                                                              \
+            push_frame(ctx, frame->stage == 1 ? node->left : node->right);              \
+            return;                                                                      \
+        }                                                                                \
+        /* Stage 2: both operands are on the value stack (right on top) */               \
+        ctype right_val = ctx->values[--ctx->value_count].field;                         \
+        ctype left_val = ctx->values[--ctx->value_count].field;                          \
+        Value result;                                                                    \
+        int overflow = 0;                                                                \
+        switch (node->value) {                                                           \
+            case '+': overflow = arithmetic##_ADD(left_val, right_val, &result.field); break; \
+            case '-': overflow = arithmetic##_SUB(left_val, right_val, &result.field); break; \
+            case '*': overflow = arithmetic##_MUL(left_val, right_val, &result.field); break; \
+            case '/':                                                                    \
+                if (right_val == 0) { /* protect against division by zero */             \
+                    exec_fail_at(ctx, node, "division by zero");                         \
+                    return;                                                              \
+                }                                                                        \
+                overflow = arithmetic##_DIV_OVERFLOWS(left_val, right_val);              \
+                if (!overflow)                                                           \
+                    result.field = left_val / right_val;                                 \
+                break;                                                                   \
+            default: {                                                                   \
+                char message[64];                                                        \
+                snprintf(message, sizeof(message), "unknown operator '%c'", (char)node->value); \
+                exec_fail_at(ctx, node, message);                                        \
+                return;                                                                  \
+            }                                                                            \
+        }                                                                                \
+        if (overflow) {                                                                  \
+            exec_fail_at(ctx, node, "integer overflow");                                 \
+            return;                                                                      \
+        }                                                                                \
+        finish_frame(ctx, result);                                                       \
+        return;                                                                          \
+    }
+
+/*
+ * Performs one evaluation step on the node at the top of the evaluation stack.
+ * This is the non-recursive equivalent of the old recursive eval_expression():
+ * instead of calling itself for the operands, it pushes them on the stack and
+ * comes back to the operator once both results are available.
+ */
+static void eval_step(ExecContext* ctx) {
+    EvalFrame* frame = &ctx->frames[ctx->frame_count - 1];
+    ASTNode* node = frame->node;
+
+    if (ctx->profiler && frame->stage == 0)
+        profiler_count_node(ctx->profiler, node); // first visit of this node
+
+    // A single switch selects both the operation and the type it works on
+    switch (EVAL_KIND(node->type, node->vtype)) {
+        VALUE_TYPES(EVAL_CASES)
+
+        // --- Case 4: Conversion to another type (one label per type of VALUE_TYPES) ---
+#define X(tag, ctype, field, literal, format, type_name, arithmetic) \
+        case EVAL_KIND(AST_CAST, tag):
+        VALUE_TYPES(X)
+#undef X
+        {
+            if (frame->stage == 0) {
+                frame->stage = 1;
+                push_frame(ctx, node->left);
+                return;
+            }
+            Value value = ctx->values[--ctx->value_count];
+            if (node->left->vtype == TYPE_INT && node->vtype == TYPE_DOUBLE) {
+                value.d = (double)value.i;
+            } else if (node->left->vtype == TYPE_DOUBLE && node->vtype == TYPE_INT) {
+                // Only values that fit in 64 bits can be converted (the fraction is dropped, as in C)
+                if (!(value.d >= -9223372036854775808.0 && value.d < 9223372036854775808.0)) {
+                    exec_fail_at(ctx, node, "double value out of int range");
+                    return;
+                }
+                value.i = (long long)value.d;
             }
+            finish_frame(ctx, value);
+            return;
         }
 
         default:
-            printf("Runtime error: invalid expression node\n");
-            exit(1);
+            exec_fail(ctx, EXEC_ERROR, "invalid expression node");
     }
 }
 
 /*
- * Executes a statement node
+ * Starts the statement 'ctx->current' by scheduling the expression it needs.
  */
-void exec_statement(ASTNode* node, SymbolTable* table) {
+static void begin_statement(ExecContext* ctx) {
+    ASTNode* node = ctx->current;
+    if (ctx->profiler)
+        profiler_count_statement(ctx->profiler, node);
     switch (node->type) {
-        case AST_ASSIGN: {
-            // Evaluate the expression on the left-hand side of the assignment node.
-            // For example, in "let x = 5 + 3;", node->left represents "5 + 3".
-            int value = eval_expression(node->left, table);
-            // Store the computed value in the symbol table.
-            set_symbol(table, node->name, value);
+        case AST_ASSIGN:
+        case AST_PRINT:
+            // Both statements evaluate their left child first.
+            // For example, in "let x = 5 + 3;" node->left represents "5 + 3",
+            // and in "print(x);" node->left represents "x".
+            push_frame(ctx, node->left);
             break;
-        }
-
-        case AST_PRINT: {
-            // Evaluate the expression to be printed, which is the left child of the AST_PRINT node.
-            // For example, in "print(x);", node->left represents "x".
-            int value = eval_expression(node->left, table);
-            printf("%d\n", value);
-            break;
-        }
 
         case AST_NUMBER:
         case AST_VAR:
         case AST_BINARY_OP:
+        case AST_CAST:
             // These cases handle standalone expressions that are not part of an assignment or print statement.
             // Examples: just writing "5;", "x;", or "3 + 4;" in the code.
             // The expression is evaluated for its side effects (if any), but the result is not stored or printed.
-            eval_expression(node, table);
+            push_frame(ctx, node);
             break;
 
         default:
-            printf("Runtime error: invalid statement node\n");
-            exit(1);
+            exec_fail(ctx, EXEC_ERROR, "invalid statement node");
+            return;
+    }
+    ctx->in_statement = 1;
+}
+
+/*
+ * Completes the statement 'ctx->current' once its expression has been evaluated,
+ * then moves to the next statement.
+ */
+static void end_statement(ExecContext* ctx) {
+    ASTNode* node = ctx->current;
+    Value value = ctx->values[--ctx->value_count];
+
+    if (node->type == AST_ASSIGN) {
+        // Store the computed value in the symbol table, with the type of the expression.
+        if (!try_set_symbol(ctx->table, node->name, node->left->vtype, value)) {
+            exec_fail(ctx, EXEC_OUT_OF_MEMORY, "out of memory for variables");
+            return;
+        }
+        // A new variable counts against the script's memory budget
+        if (ctx->memory_limit != 0 && exec_memory_usage(ctx) > ctx->memory_limit) {
+            exec_fail(ctx, EXEC_OUT_OF_MEMORY, "memory budget exceeded");
+            return;
+        }
+    } else if (node->type == AST_PRINT) {
+        // The type of the printed expression selects the field to read and the format
+        switch (node->left->vtype) {
+#define X(tag, ctype, field, literal, format, type_name, arithmetic) \
+            case tag: fprintf(ctx->out, format "\n", value.field); break;
+            VALUE_TYPES(X)
+#undef X
+            default: break;
+        }
+    }
+
+    ctx->in_statement = 0;
+    ctx->current = node->right; // move to next statement
+}
+
+/*
+ * Performs a single step of the program.
+ */
+static void exec_step(ExecContext* ctx) {
+    if (ctx->frame_count > 0)
+        eval_step(ctx);
+    else if (ctx->in_statement)
+        end_statement(ctx);
+    else
+        begin_statement(ctx);
+    ctx->steps++;
+    if (ctx->profiler)
+        profiler_tick(ctx->profiler, ctx);
+}
+
+ExecStatus exec_run(ExecContext* ctx, long max_steps) {
+    if (ctx->status == EXEC_DONE || ctx->status == EXEC_ERROR || ctx->status == EXEC_OUT_OF_MEMORY)
+        return ctx->status;
+
+    ctx->status = EXEC_YIELDED;
+    long budget = max_steps;
+    while (max_steps <= 0 || budget-- > 0) {
+        if (ctx->current == NULL) {
+            ctx->status = EXEC_DONE;
+            return ctx->status;
+        }
+        exec_step(ctx);
+        if (ctx->status != EXEC_YIELDED)
+            return ctx->status;
+    }
+    // A program that finished exactly on the last step of the budget is done, not suspended
+    if (ctx->current == NULL)
+        ctx->status = EXEC_DONE;
+    return ctx->status;
+}
+
+/*
+ * Evaluates an expression node to completion
+ */
+Value eval_expression(ASTNode* node, SymbolTable* table) {
+    ExecContext ctx;
+    exec_init(&ctx, NULL, table, NULL);
+    if (!node->typed)
+        exec_fail(&ctx, EXEC_ERROR, "expression has not been type-checked (call infer_types() first)");
+    else
+        push_frame(&ctx, node);
+    while (ctx.frame_count > 0 && ctx.status == EXEC_READY)
+        eval_step(&ctx);
+    if (ctx.status != EXEC_READY) {
+        printf("Runtime error: %s\n", ctx.error);
+        exit(1);
+    }
+    Value value = ctx.values[0];
+    exec_free(&ctx);
+    return value;
+}
+
+/*
+ * Executes a single statement node to completion
+ */
+void exec_statement(ASTNode* node, SymbolTable* table) {
+    ExecContext ctx;
+    exec_init(&ctx, node, table, NULL);
+    while (ctx.current == node && ctx.status == EXEC_READY)
+        exec_step(&ctx);
+    if (ctx.status != EXEC_READY) {
+        printf("Runtime error: %s\n", ctx.error);
+        exit(1);
     }
+    exec_free(&ctx);
 }
 
 /*
  * Main interpreter entry point
- * Traverses the AST (linked list of statements)
+ * Traverses the AST (linked list of statements) in a single run, without a step budget
  */
 void interpret(ASTNode* root) {
     SymbolTable table;
     init_symbol_table(&table);
+    interpret_program(root, &table, NULL);
+    free_symbol_table(&table);
+}
 
-    ASTNode* current = root;
-    while (current != NULL) {
-        exec_statement(current, &table);
-        current = current->right; // move to next statement
+/*
+ * Runs a whole program on an existing symbol table, optionally reporting to a profiler.
+ * A program that has not been through infer_types() yet is typed here, against 'table'.
+ */
+void interpret_program(ASTNode* root, SymbolTable* table, struct Profiler* profiler) {
+    if (root != NULL && !root->typed)
+        infer_types(root, table);
+
+    ExecContext ctx;
+    exec_init(&ctx, root, table, NULL);
+    ctx.profiler = profiler;
+    if (exec_run(&ctx, 0) != EXEC_DONE) {
+        printf("Runtime error: %s\n", ctx.error);
+        exit(1);
     }
+    exec_free(&ctx);
 }
@@ -2,45 +2,76 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <string.h>
+#include <limits.h>
 #include "../include/lexer.h"
 
 /*
  * Simple lexer for the Mini C Compiler
  * Converts source code string into a list of tokens.
- * Supports numbers, basic operators, 'let' and 'print' keywords, identifiers, and semicolons.
+ * Supports integer and floating-point numbers, basic operators, 'let' and 'print' keywords,
+ * identifiers, type annotations (':') and semicolons.
  */
 
 // Helper function to create a new token
-Token create_token(TokenType type, int value, const char* name) {
+Token create_token(TokenType type, long long value, const char* name) {
     Token token;
     token.type = type;
     token.value = value;
+    token.fvalue = 0.0;
     if (name)
         strncpy(token.name, name, sizeof(token.name) - 1);
     else
         token.name[0] = '\0';
+    token.line = 0;
+    token.column = 0;
     return token;
 }
 
+// Helper function to append a token to the list, recording where it starts in the source
+// The array doubles in size when it is full, so any number of tokens can be stored
+static void add_token(TokenList* list, Token token, int line, int column) {
+    if (list->count == list->capacity) {
+        list->capacity *= 2;
+        list->tokens = realloc(list->tokens, list->capacity * sizeof(Token));
+        if (!list->tokens) {
+            printf("Lexer error: out of memory\n");
+            exit(1);
+        }
+    }
+    token.line = line;
+    token.column = column;
+    list->tokens[list->count++] = token;
+}
+
 // Lexical analysis function
 TokenList lex(const char* source) {
     TokenList list;
-    list.tokens = malloc(128 * sizeof(Token)); // initial size, can grow
+    list.capacity = 128;
+    list.tokens = malloc(list.capacity * sizeof(Token)); // initial size, can grow
     list.count = 0;
 
     int i = 0;
+    int line = 1;        // current line number
+    int line_start = 0;  // index in 'source' where the current line begins
     while (source[i] != '\0') {
         char c = source[i];
+        int column = i - line_start + 1; // column of the token that starts at 'i'
 
         // Skip whitespace
         if (isspace(c)) {
+            if (c == '\n') { // a new line starts right after '\n'
+                line++;
+                line_start = i + 1;
+            }
             i++;
             continue;
         }
 
         // Numbers
         if (isdigit(c)) {
-            int value = 0; // value will contain the complete integer once the entire numeric token has been read
+            int start = i;       // first character of the number, used if it turns out to be a floating-point literal
+            long long value = 0; // value will contain the complete integer once the entire numeric token has been read
+            int overflow = 0;    // set if the digits do not fit in a 64-bit integer
             /* Cycles until consecutive numeric characters are found
              * This is used to read numbers with multiple digits (e.g., 12345)
              */
@@ -53,17 +84,41 @@ TokenList lex(const char* source) {
                  * first cycle: value = 0*10 + 1 = 1
                  * second cycle: value = 1*10 + 2 = 12
                  * third cycle: value = 12*10 + 3 = 123
+                 * Before multiplying, check that the result still fits in 64 bits instead of silently overflowing
                  */
-                value = value * 10 + (source[i] - '0');
+                int digit = source[i] - '0';
+                if (value > (LLONG_MAX - digit) / 10)
+                    overflow = 1;
+                else
+                    value = value * 10 + digit;
                 // Move to the next character
                 i++;
             }
+
+            /*
+             * A '.' followed by a digit makes it a floating-point literal (e.g. 2.5)
+             * strtod() converts the whole literal, starting again from its first character
+             */
+            if (source[i] == '.' && isdigit(source[i + 1])) {
+                char* end;
+                Token token = create_token(T_FLOAT, 0, NULL);
+                token.fvalue = strtod(source + start, &end);
+                i = (int)(end - source);
+                add_token(&list, token, line, column);
+                continue;
+            }
+
+            if (overflow) {
+                printf("Lexer error: integer literal too large at line %d, column %d\n", line, column);
+                exit(1);
+            }
+
             /*
              * Once the number is read, creates a token of type T_NUMBER with the integer value just calculated
-             * Adds it to the list of tokens (list.tokens)
-             * list.count++ → updates the total token count
+             * Adds it to the list of tokens (list.tokens) together with its position in the source
+             * add_token() also updates the total token count
             */
-            list.tokens[list.count++] = create_token(T_NUMBER, value, NULL);
+            add_token(&list, create_token(T_NUMBER, value, NULL), line, column);
             continue;
         }
 
@@ -91,34 +146,35 @@ TokenList lex(const char* source) {
              * Otherwise → the word is a generic identifier (e.g., variable name) → creates a T_IDENTIFIER token with the name copied to the token's name field
              */
             if (strcmp(buffer, "let") == 0)
-                list.tokens[list.count++] = create_token(T_LET, 0, NULL);
+                add_token(&list, create_token(T_LET, 0, NULL), line, column);
             else if (strcmp(buffer, "print") == 0)
-                list.tokens[list.count++] = create_token(T_PRINT, 0, NULL);
+                add_token(&list, create_token(T_PRINT, 0, NULL), line, column);
             else
-                list.tokens[list.count++] = create_token(T_IDENTIFIER, 0, buffer);
+                add_token(&list, create_token(T_IDENTIFIER, 0, buffer), line, column);
 
             continue;
         }
 
         // Operators and punctuation
         switch (c) {
-            case '+': list.tokens[list.count++] = create_token(T_PLUS, 0, NULL); break;
-            case '-': list.tokens[list.count++] = create_token(T_MINUS, 0, NULL); break;
-            case '*': list.tokens[list.count++] = create_token(T_MULT, 0, NULL); break;
-            case '/': list.tokens[list.count++] = create_token(T_DIV, 0, NULL); break;
-            case '=': list.tokens[list.count++] = create_token(T_EQUAL, 0, NULL); break;
-            case ';': list.tokens[list.count++] = create_token(T_SEMICOLON, 0, NULL); break;
-            case '(': list.tokens[list.count++] = create_token(T_LPAREN, 0, NULL); break;
-            case ')': list.tokens[list.count++] = create_token(T_RPAREN, 0, NULL); break;
+            case '+': add_token(&list, create_token(T_PLUS, 0, NULL), line, column); break;
+            case '-': add_token(&list, create_token(T_MINUS, 0, NULL), line, column); break;
+            case '*': add_token(&list, create_token(T_MULT, 0, NULL), line, column); break;
+            case '/': add_token(&list, create_token(T_DIV, 0, NULL), line, column); break;
+            case '=': add_token(&list, create_token(T_EQUAL, 0, NULL), line, column); break;
+            case ':': add_token(&list, create_token(T_COLON, 0, NULL), line, column); break;
+            case ';': add_token(&list, create_token(T_SEMICOLON, 0, NULL), line, column); break;
+            case '(': add_token(&list, create_token(T_LPAREN, 0, NULL), line, column); break;
+            case ')': add_token(&list, create_token(T_RPAREN, 0, NULL), line, column); break;
             default:
-                printf("Unknown character: %c\n", c);
+                printf("Unknown character: %c at line %d, column %d\n", c, line, column);
                 exit(1);
         }
         i++;
     }
 
     // End-of-file token
-    list.tokens[list.count++] = create_token(T_EOF, 0, NULL);
+    add_token(&list, create_token(T_EOF, 0, NULL), line, i - line_start + 1);
 
     return list;
 }
@@ -128,7 +184,8 @@ void print_tokens(TokenList* list) {
     for (int i = 0; i < list->count; i++) {
         Token t = list->tokens[i];
         switch (t.type) {
-            case T_NUMBER: printf("NUMBER(%d)\n", t.value); break;
+            case T_NUMBER: printf("NUMBER(%lld)\n", t.value); break;
+            case T_FLOAT: printf("FLOAT(%g)\n", t.fvalue); break;
             case T_PLUS: printf("PLUS\n"); break;
             case T_MINUS: printf("MINUS\n"); break;
             case T_MULT: printf("MULT\n"); break;
@@ -136,6 +193,7 @@ void print_tokens(TokenList* list) {
             case T_LET: printf("LET\n"); break;
             case T_IDENTIFIER: printf("IDENT(%s)\n", t.name); break;
             case T_EQUAL: printf("EQUAL\n"); break;
+            case T_COLON: printf("COLON\n"); break;
             case T_PRINT: printf("PRINT\n"); break;
             case T_SEMICOLON: printf("SEMICOLON\n"); break;
             case T_EOF: printf("EOF\n"); break;
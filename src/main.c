@@ -1,8 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../include/lexer.h"
 #include "../include/parser.h"
 #include "../include/interpreter.h"
+#include "../include/profiler.h"
+#include "../include/snapshot.h"
+#include "../include/typecheck.h"
 #include "../include/utils.h"
 
 /*
@@ -10,19 +14,63 @@
  * This program demonstrates the compiler pipeline:
  * 1. Lexical analysis (convert source code into tokens)
  * 2. Parsing (build an Abstract Syntax Tree from tokens)
- * 3. Interpretation (execute the AST) - to be implemented later
+ *    followed by type inference (give every node its int / double type)
+ * 3. Interpretation (execute the AST)
+ *
+ * With --profile, the program is also profiled: a hot-statement report is printed
+ * after the program output and the sampled stacks are written to "<source>.folded".
+ *
+ * With --save-snapshot <file>, the variables left by the program (e.g. a prelude of
+ * 'let' constants) are saved to <file>. With --snapshot <file>, the program starts
+ * with the variables stored in <file> instead of an empty symbol table.
  */
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
+    const char* source_path = NULL;
+    const char* snapshot_path = NULL;       // --snapshot: initial variables
+    const char* save_snapshot_path = NULL;  // --save-snapshot: where to save the final variables
+    int profile = 0;
+
+    const char* usage = "Example usage: %s [--profile] [--snapshot prelude.snap] [--save-snapshot out.snap] examples/test.txt\n";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0) {
+            profile = 1;
+        } else if (strcmp(argv[i], "--snapshot") == 0 || strcmp(argv[i], "--save-snapshot") == 0) {
+            // Both options need a file name right after them
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: option %s requires a snapshot file name.\n", argv[i]);
+                fprintf(stderr, usage, argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (strcmp(argv[i], "--snapshot") == 0)
+                snapshot_path = argv[++i];
+            else
+                save_snapshot_path = argv[++i];
+        } else {
+            source_path = argv[i];
+        }
+    }
+
+    if (source_path == NULL) {
         fprintf(stderr, "Error: No source file specified.\n");
         fprintf(stderr, "Please provide the path to the source code file when running the program.\n");
-        fprintf(stderr, "Example usage: %s examples/test.txt\n", argv[0]);
+        fprintf(stderr, usage, argv[0]);
         return EXIT_FAILURE;
     }
 
+    // Initial variables: empty, or mapped from a previously saved snapshot
+    SymbolTable table;
+    Snapshot snapshot = { NULL, 0 };
+    if (snapshot_path != NULL) {
+        if (snapshot_load(snapshot_path, &snapshot, &table) != 0)
+            return EXIT_FAILURE;
+    } else {
+        init_symbol_table(&table);
+    }
+
     // Step 0: Read source code from the provided file
-    char* source_code = read_file(argv[1]);
+    char* source_code = read_file(source_path);
     printf("Source code:\n%s\n\n", source_code);
 
     // Step 1: Lexer - convert text into a list of tokens
@@ -32,12 +80,47 @@ int main(int argc, char* argv[]) {
 
     // Step 2: Parser - convert tokens into an AST
     ASTNode* ast = parse(&tokens);
+
+    // Step 2b: Type inference - variables loaded from a snapshot keep their types
+    infer_types(ast, &table);
     printf("\nAST:\n");
     print_ast(ast, 0);
 
-    // Step 3: Interpreter - will execute the AST
+    // Step 3: Interpreter - execute the AST
     printf("\nProgram output:\n");
-    interpret(ast);
+    if (!profile) {
+        interpret_program(ast, &table, NULL);
+    } else {
+        Profiler profiler;
+        profiler_init(&profiler, 64);
+        interpret_program(ast, &table, &profiler);
+
+        printf("\nProfile:\n");
+        profiler_report(&profiler, stdout);
+
+        // Folded stacks go next to the source file, e.g. examples/test.txt.folded
+        char folded_path[1024];
+        snprintf(folded_path, sizeof(folded_path), "%s.folded", source_path);
+        FILE* folded = fopen(folded_path, "w");
+        if (!folded) {
+            perror("Error opening folded stack file");
+        } else {
+            profiler_write_folded(&profiler, folded);
+            fclose(folded);
+            printf("\nFolded stacks written to %s\n", folded_path);
+        }
+        profiler_free(&profiler);
+    }
+
+    if (save_snapshot_path != NULL) {
+        int saved = snapshot_save(save_snapshot_path, &table);
+        if (saved < 0)
+            return EXIT_FAILURE;
+        printf("\nSnapshot of %d variables written to %s\n", saved, save_snapshot_path);
+    }
+
+    free_symbol_table(&table);
+    snapshot_close(&snapshot);
 
     free(source_code);
     return 0;
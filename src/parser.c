@@ -6,10 +6,13 @@
 /* 
  * Helper function to create a new AST node
  */
-ASTNode* create_node(ASTNodeType type, int value, const char* name, ASTNode* left, ASTNode* right) {
+ASTNode* create_node(ASTNodeType type, long long value, const char* name, ASTNode* left, ASTNode* right) {
     ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
     node->type = type;
+    node->vtype = TYPE_INT;
+    node->typed = 0;
     node->value = value;
+    node->fvalue = 0.0;
     if (name != NULL) {
         strncpy(node->name, name, 31);
         node->name[31] = '\0';
@@ -18,6 +21,18 @@ ASTNode* create_node(ASTNodeType type, int value, const char* name, ASTNode* lef
     }
     node->left = left;
     node->right = right;
+    node->line = 0;
+    node->column = 0;
+    return node;
+}
+
+/*
+ * Helper function to record where a node comes from in the source code
+ * (used by error messages and by the profiler)
+ */
+static ASTNode* located(ASTNode* node, Token token) {
+    node->line = token.line;
+    node->column = token.column;
     return node;
 }
 
@@ -35,8 +50,31 @@ ASTNode* parse_statement(TokenList* tokens, int* pos) {
         Token var = tokens->tokens[*pos]; // capture the variable name ('x')
         (*pos)++; // move past variable token
 
+        /*
+         * Optional type annotation, e.g. let x: double = 1;
+         * The type name is read as an identifier and compared with the names in VALUE_TYPES
+         */
+        int annotated = 0;
+        ValueType declared = TYPE_INT;
+        Token type_token = current;
+        if (tokens->tokens[*pos].type == T_COLON) {
+            (*pos)++; // skip ':'
+            type_token = tokens->tokens[*pos];
+            int found = 0;
+#define X(tag, ctype, field, literal, format, type_name, arithmetic) \
+            if (type_token.type == T_IDENTIFIER && strcmp(type_token.name, type_name) == 0) { declared = tag; found = 1; }
+            VALUE_TYPES(X)
+#undef X
+            if (!found) {
+                printf("Syntax error: unknown type at line %d, column %d\n", type_token.line, type_token.column);
+                exit(1);
+            }
+            annotated = 1;
+            (*pos)++; // skip the type name
+        }
+
         if (tokens->tokens[*pos].type != T_EQUAL) { // check for '='
-            printf("Syntax error: expected '=' at pos=%d\n", *pos);
+            printf("Syntax error: expected '=' at line %d, column %d\n", tokens->tokens[*pos].line, tokens->tokens[*pos].column);
             exit(1);
         }
         (*pos)++; // skip '='
@@ -48,11 +86,21 @@ ASTNode* parse_statement(TokenList* tokens, int* pos) {
         ASTNode* expr = parse_expression(tokens, pos);
 
         if (tokens->tokens[*pos].type != T_SEMICOLON) { // expect ';' at the end of the statement
-            printf("Syntax error: expected ';' at pos=%d\n", *pos);
+            printf("Syntax error: expected ';' at line %d, column %d\n", tokens->tokens[*pos].line, tokens->tokens[*pos].column);
             exit(1);
         }
         (*pos)++; // skip ';'
 
+        /*
+         * With an annotation, the value is converted to the declared type:
+         * "let x: double = 1;" becomes AST_ASSIGN(x) -> AST_CAST(double) -> AST_NUMBER(1)
+         * (infer_types() removes the conversion again when the value already has that type)
+         */
+        if (annotated) {
+            expr = located(create_node(AST_CAST, 0, NULL, expr, NULL), type_token);
+            expr->vtype = declared;
+        }
+
         /*
          * Resulting AST structure for "let x = 5 + 3;"
          * AST_ASSIGN(x)
@@ -64,7 +112,7 @@ ASTNode* parse_statement(TokenList* tokens, int* pos) {
          * - The computed expression (5 + 3) is the left child of the assignment node.
          * - The right child is NULL because it is not needed for assignments.
          */
-        return create_node(AST_ASSIGN, 0, var.name, expr, NULL);
+        return located(create_node(AST_ASSIGN, 0, var.name, expr, NULL), current);
 
     } else if (current.type == T_PRINT) { // if statement starts with 'print'
         (*pos)++; // move past 'print' keyword
@@ -75,7 +123,7 @@ ASTNode* parse_statement(TokenList* tokens, int* pos) {
         ASTNode* expr = parse_expression(tokens, pos);
 
         if (tokens->tokens[*pos].type != T_SEMICOLON) { // expect ';' at the end of the statement
-            printf("Syntax error: expected ';' at pos=%d\n", *pos);
+            printf("Syntax error: expected ';' at line %d, column %d\n", tokens->tokens[*pos].line, tokens->tokens[*pos].column);
             exit(1);
         }
         (*pos)++; // skip ';'
@@ -88,13 +136,13 @@ ASTNode* parse_statement(TokenList* tokens, int* pos) {
          * - The variable to print (i.e., x) is the left child of the AST_PRINT node.
          * - The right child is NULL because it is not needed for print statements.
          */
-        return create_node(AST_PRINT, 0, NULL, expr, NULL);
+        return located(create_node(AST_PRINT, 0, NULL, expr, NULL), current);
 
     } else if (current.type == T_LPAREN) { // if statement starts with '(' -> e.g. print(x);
         (*pos)++; // skip '('
         ASTNode* expr = parse_expression(tokens, pos);
         if (tokens->tokens[*pos].type != T_RPAREN) {
-            printf("Syntax error: expected ')' at pos=%d\n", *pos);
+            printf("Syntax error: expected ')' at line %d, column %d\n", tokens->tokens[*pos].line, tokens->tokens[*pos].column);
             exit(1);
         }
         (*pos)++; // skip ')'
@@ -119,10 +167,15 @@ ASTNode* parse_expression(TokenList* tokens, int* pos) {
 
     if (current.type == T_NUMBER) { // if token is a number (e.g. '5' in "5 + 3")
         // left is a pointer to an AST node of type = AST_NUMBER; value contains the numeeric value read from the token (e.g. '5')
-        left = create_node(AST_NUMBER, current.value, NULL, NULL, NULL);
+        left = located(create_node(AST_NUMBER, current.value, NULL, NULL, NULL), current);
+        (*pos)++;
+    } else if (current.type == T_FLOAT) { // floating-point literal (e.g. '2.5'): same node, with type double
+        left = located(create_node(AST_NUMBER, 0, NULL, NULL, NULL), current);
+        left->vtype = TYPE_DOUBLE;
+        left->fvalue = current.fvalue;
         (*pos)++;
     } else if (current.type == T_IDENTIFIER) { // if token is a variable (e.g. 'x' in "x * 2") (it means that the expression contains a variable instead of a number)
-        left = create_node(AST_VAR, 0, current.name, NULL, NULL);
+        left = located(create_node(AST_VAR, 0, current.name, NULL, NULL), current);
         (*pos)++;
     } else if (current.type == T_LPAREN) {  // if token is '('
         (*pos)++; // skip the '(' token and move to the next one
@@ -136,13 +189,13 @@ ASTNode* parse_expression(TokenList* tokens, int* pos) {
         // After parsing the sub-expression, we expect a closing parenthesis ')'
         // If the next token is not ')', it's a syntax error
         if (tokens->tokens[*pos].type != T_RPAREN) {
-            printf("Syntax error: expected ')' at pos=%d\n", *pos);
+            printf("Syntax error: expected ')' at line %d, column %d\n", tokens->tokens[*pos].line, tokens->tokens[*pos].column);
             exit(1);
         }
 
         (*pos)++;  // Skip the ')' token and continue parsing
     } else {
-        printf("Syntax error: unexpected token at pos=%d\n", *pos);
+        printf("Syntax error: unexpected token at line %d, column %d\n", tokens->tokens[*pos].line, tokens->tokens[*pos].column);
         exit(1);
     }
 
@@ -157,9 +210,10 @@ ASTNode* parse_expression(TokenList* tokens, int* pos) {
             case T_MULT: op = '*'; break;
             case T_DIV: op = '/'; break;
         }
+        Token op_token = current; // the operator's position identifies the operation in the source
         (*pos)++;
         ASTNode* right = parse_expression(tokens, pos);
-        left = create_node(AST_BINARY_OP, op, NULL, left, right);
+        left = located(create_node(AST_BINARY_OP, op, NULL, left, right), op_token);
         current = tokens->tokens[*pos];
     }
 
@@ -175,6 +229,7 @@ ASTNode* parse_expression(TokenList* tokens, int* pos) {
 ASTNode* parse(TokenList* tokens) {
     int pos = 0;
     ASTNode* root = NULL;
+    ASTNode* last = NULL; // last statement appended, so long programs do not rescan the whole list
 
     /*
      * e.g. let x = 5 + 3; print(x);
@@ -204,17 +259,38 @@ ASTNode* parse(TokenList* tokens) {
             root = stmt;
         } else {
             // append statements in a right-skewed list
-            ASTNode* temp = root;
+            ASTNode* temp = last;
             // the while loop runs through the nodes on the right until it finds the last node (the one with right == NULL).
             while (temp->right != NULL) temp = temp->right;
             // add the new statement to the end of the list
             temp->right = stmt; 
         }
+        last = stmt;
     }
 
     return root;
 }
 
+const char* value_type_name(ValueType type) {
+    switch (type) {
+#define X(tag, ctype, field, literal, format, type_name, arithmetic) \
+        case tag: return type_name;
+        VALUE_TYPES(X)
+#undef X
+        default: return "?";
+    }
+}
+
+int format_literal(char* buffer, size_t size, const ASTNode* node) {
+    switch (node->vtype) {
+#define X(tag, ctype, field, literal, format, type_name, arithmetic) \
+        case tag: return snprintf(buffer, size, format, node->literal);
+        VALUE_TYPES(X)
+#undef X
+        default: return snprintf(buffer, size, "?");
+    }
+}
+
 /* 
  * Recursively prints the AST
  */
@@ -224,14 +300,17 @@ void print_ast(ASTNode* node, int indent) {
     for (int i = 0; i < indent; i++) printf("  ");
 
     switch (node->type) {
-        case AST_NUMBER:
-            printf("AST_NUMBER(%d)\n", node->value);
+        case AST_NUMBER: {
+            char text[64];
+            format_literal(text, sizeof(text), node);
+            printf("AST_NUMBER(%s)\n", text);
             break;
+        }
         case AST_VAR:
             printf("AST_VAR(%s)\n", node->name);
             break;
         case AST_BINARY_OP:
-            printf("AST_BINARY_OP(%c)\n", node->value);
+            printf("AST_BINARY_OP(%c)\n", (char)node->value);
             print_ast(node->left, indent + 1);
             print_ast(node->right, indent + 1);
             break;
@@ -243,6 +322,10 @@ void print_ast(ASTNode* node, int indent) {
             printf("AST_PRINT\n");
             print_ast(node->left, indent + 1);
             break;
+        case AST_CAST:
+            printf("AST_CAST(%s)\n", value_type_name(node->vtype));
+            print_ast(node->left, indent + 1);
+            break;
         default:
             printf("Unknown AST node\n");
     }
@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "../include/profiler.h"
+
+/*
+ * Sampling profiler.
+ * Evaluation counts are exact (one increment per statement / node visit), while
+ * time is sampled: every 'sample_interval' steps the clock is read and the time
+ * elapsed since the previous sample is charged to the current evaluation stack.
+ */
+
+// Reads a monotonic clock in nanoseconds
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void table_init(ProfileTable* table) {
+    table->count = 0;
+    table->capacity = 4096; // large enough that small programs never need to grow it
+    table->entries = calloc(table->capacity, sizeof(NodeProfile));
+    if (!table->entries) {
+        printf("Profiler error: out of memory\n");
+        exit(1);
+    }
+}
+
+// Hash of a node address (nodes are heap blocks, so the lowest bits carry no information)
+static unsigned int hash_node(const ASTNode* node) {
+    uintptr_t key = (uintptr_t)node >> 4;
+    return (unsigned int)(key * 2654435761u);
+}
+
+/*
+ * Returns the entry for 'node', creating it if needed.
+ * Open addressing with linear probing; the table doubles when it is 70% full.
+ * The time spent growing the table is removed from the current sample interval,
+ * so the profiler's own work is not charged to the node being evaluated.
+ */
+static NodeProfile* table_get(Profiler* profiler, ProfileTable* table, ASTNode* node) {
+    if ((table->count + 1) * 10 > table->capacity * 7) {
+        long long start = now_ns();
+        ProfileTable bigger;
+        bigger.count = 0;
+        bigger.capacity = table->capacity * 2;
+        bigger.entries = calloc(bigger.capacity, sizeof(NodeProfile));
+        if (!bigger.entries) {
+            printf("Profiler error: out of memory\n");
+            exit(1);
+        }
+        for (int i = 0; i < table->capacity; i++) {
+            if (table->entries[i].node) {
+                unsigned int slot = hash_node(table->entries[i].node) & (bigger.capacity - 1);
+                while (bigger.entries[slot].node) slot = (slot + 1) & (bigger.capacity - 1);
+                bigger.entries[slot] = table->entries[i];
+                bigger.count++;
+            }
+        }
+        free(table->entries);
+        *table = bigger;
+        profiler->last_sample_ns += now_ns() - start; // pause the clock while growing
+    }
+
+    unsigned int slot = hash_node(node) & (table->capacity - 1);
+    while (table->entries[slot].node && table->entries[slot].node != node)
+        slot = (slot + 1) & (table->capacity - 1);
+    if (!table->entries[slot].node) {
+        table->entries[slot].node = node;
+        table->count++;
+    }
+    return &table->entries[slot];
+}
+
+void profiler_init(Profiler* profiler, long sample_interval) {
+    table_init(&profiler->statements);
+    table_init(&profiler->nodes);
+    profiler->stack_count = 0;
+    profiler->stack_capacity = 256;
+    profiler->stacks = calloc(profiler->stack_capacity, sizeof(FoldedStack));
+    profiler->scratch_size = 1024;
+    profiler->scratch = malloc(profiler->scratch_size);
+    if (!profiler->stacks || !profiler->scratch) {
+        printf("Profiler error: out of memory\n");
+        exit(1);
+    }
+    profiler->sample_interval = sample_interval > 0 ? sample_interval : 64;
+    profiler->countdown = profiler->sample_interval;
+    profiler->last_sample_ns = now_ns();
+    profiler->sampled_ns = 0;
+}
+
+void profiler_count_statement(Profiler* profiler, ASTNode* statement) {
+    table_get(profiler, &profiler->statements, statement)->evaluations++;
+}
+
+void profiler_count_node(Profiler* profiler, ASTNode* node) {
+    table_get(profiler, &profiler->nodes, node)->evaluations++;
+}
+
+/*
+ * Writes a short human-readable name for a statement or node, e.g. "let x (line 1)" or "+ (3:9)"
+ */
+static int statement_label(char* buffer, size_t size, const ASTNode* node) {
+    switch (node->type) {
+        case AST_ASSIGN: return snprintf(buffer, size, "let %s (line %d)", node->name, node->line);
+        case AST_PRINT:  return snprintf(buffer, size, "print (line %d)", node->line);
+        default:         return snprintf(buffer, size, "expression (line %d)", node->line);
+    }
+}
+
+static int node_label(char* buffer, size_t size, const ASTNode* node) {
+    switch (node->type) {
+        case AST_NUMBER: {
+            char text[64];
+            format_literal(text, sizeof(text), node);
+            return snprintf(buffer, size, "%s (%d:%d)", text, node->line, node->column);
+        }
+        case AST_VAR:       return snprintf(buffer, size, "%s (%d:%d)", node->name, node->line, node->column);
+        case AST_BINARY_OP: return snprintf(buffer, size, "%c (%d:%d)", (char)node->value, node->line, node->column);
+        case AST_CAST:      return snprintf(buffer, size, "(%s) (%d:%d)", value_type_name(node->vtype), node->line, node->column);
+        default:            return snprintf(buffer, size, "? (%d:%d)", node->line, node->column);
+    }
+}
+
+// FNV-1a hash of a stack string
+static unsigned int hash_string(const char* text) {
+    unsigned int hash = 2166136261u;
+    while (*text) {
+        hash ^= (unsigned char)*text++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Adds 'ns' to the folded stack 'stack', creating the entry if needed
+static void add_folded(Profiler* profiler, const char* stack, long long ns) {
+    if ((profiler->stack_count + 1) * 10 > profiler->stack_capacity * 7) {
+        int capacity = profiler->stack_capacity * 2;
+        FoldedStack* bigger = calloc(capacity, sizeof(FoldedStack));
+        if (!bigger) {
+            printf("Profiler error: out of memory\n");
+            exit(1);
+        }
+        for (int i = 0; i < profiler->stack_capacity; i++) {
+            if (profiler->stacks[i].stack) {
+                unsigned int slot = hash_string(profiler->stacks[i].stack) & (capacity - 1);
+                while (bigger[slot].stack) slot = (slot + 1) & (capacity - 1);
+                bigger[slot] = profiler->stacks[i];
+            }
+        }
+        free(profiler->stacks);
+        profiler->stacks = bigger;
+        profiler->stack_capacity = capacity;
+    }
+
+    unsigned int slot = hash_string(stack) & (profiler->stack_capacity - 1);
+    while (profiler->stacks[slot].stack && strcmp(profiler->stacks[slot].stack, stack) != 0)
+        slot = (slot + 1) & (profiler->stack_capacity - 1);
+    if (!profiler->stacks[slot].stack) {
+        profiler->stacks[slot].stack = strdup(stack);
+        profiler->stack_count++;
+    }
+    profiler->stacks[slot].ns += ns;
+}
+
+// Appends one frame label to the scratch buffer, growing it when needed
+static size_t append_frame(Profiler* profiler, size_t length, const char* label) {
+    size_t needed = length + strlen(label) + 2; // ';' + label + '\0'
+    if (needed > profiler->scratch_size) {
+        while (needed > profiler->scratch_size) profiler->scratch_size *= 2;
+        profiler->scratch = realloc(profiler->scratch, profiler->scratch_size);
+        if (!profiler->scratch) {
+            printf("Profiler error: out of memory\n");
+            exit(1);
+        }
+    }
+    if (length > 0) profiler->scratch[length++] = ';';
+    strcpy(profiler->scratch + length, label);
+    return length + strlen(label);
+}
+
+/*
+ * Charges the time elapsed since the previous sample to the current stack:
+ * the statement being executed, then every node on the evaluation stack (outermost first).
+ */
+static void take_sample(Profiler* profiler, const ExecContext* ctx) {
+    long long elapsed = now_ns() - profiler->last_sample_ns;
+
+    ASTNode* statement = ctx->current;
+    if (statement == NULL) return; // the program has finished
+
+    char label[96];
+    NodeProfile* entry = table_get(profiler, &profiler->statements, statement);
+    entry->total_ns += elapsed;
+    if (ctx->frame_count == 0) entry->self_ns += elapsed;
+
+    statement_label(label, sizeof(label), statement);
+    size_t length = append_frame(profiler, 0, label);
+
+    for (int i = 0; i < ctx->frame_count; i++) {
+        ASTNode* node = ctx->frames[i].node;
+        entry = table_get(profiler, &profiler->nodes, node);
+        entry->total_ns += elapsed;
+        if (i == ctx->frame_count - 1) entry->self_ns += elapsed;
+
+        node_label(label, sizeof(label), node);
+        length = append_frame(profiler, length, label);
+    }
+
+    add_folded(profiler, profiler->scratch, elapsed);
+    profiler->sampled_ns += elapsed;
+
+    // Restart the clock only now, so the cost of the bookkeeping above is not charged to the program
+    profiler->last_sample_ns = now_ns();
+}
+
+void profiler_tick(Profiler* profiler, const ExecContext* ctx) {
+    if (--profiler->countdown > 0) return;
+    profiler->countdown = profiler->sample_interval;
+    take_sample(profiler, ctx);
+}
+
+// Sort order for the report: most time first, then most evaluations
+static int compare_profiles(const void* a, const void* b) {
+    const NodeProfile* x = (const NodeProfile*)a;
+    const NodeProfile* y = (const NodeProfile*)b;
+    if (x->total_ns != y->total_ns) return x->total_ns < y->total_ns ? 1 : -1;
+    if (x->evaluations != y->evaluations) return x->evaluations < y->evaluations ? 1 : -1;
+    return 0;
+}
+
+// Copies the used entries of a table into a new array sorted with compare_profiles()
+static NodeProfile* sorted_entries(const ProfileTable* table) {
+    NodeProfile* sorted = malloc((table->count + 1) * sizeof(NodeProfile));
+    if (!sorted) {
+        printf("Profiler error: out of memory\n");
+        exit(1);
+    }
+    int n = 0;
+    for (int i = 0; i < table->capacity; i++)
+        if (table->entries[i].node) sorted[n++] = table->entries[i];
+    qsort(sorted, n, sizeof(NodeProfile), compare_profiles);
+    return sorted;
+}
+
+void profiler_report(Profiler* profiler, FILE* out) {
+    double total_ms = profiler->sampled_ns / 1e6;
+    double percent_base = profiler->sampled_ns > 0 ? (double)profiler->sampled_ns : 1.0;
+    char label[96];
+
+    // Only the hottest entries: large programs have far too many to list
+    int limit = profiler->statements.count < 20 ? profiler->statements.count : 20;
+    fprintf(out, "Hot statements (top %d, %.3f ms sampled every %ld steps):\n", limit, total_ms, profiler->sample_interval);
+    fprintf(out, "  %10s %10s %8s  %s\n", "evals", "time(ms)", "time%", "statement");
+    NodeProfile* sorted = sorted_entries(&profiler->statements);
+    for (int i = 0; i < limit; i++) {
+        statement_label(label, sizeof(label), sorted[i].node);
+        fprintf(out, "  %10ld %10.3f %7.1f%%  %s\n", sorted[i].evaluations, sorted[i].total_ns / 1e6,
+                100.0 * sorted[i].total_ns / percent_base, label);
+    }
+    free(sorted);
+
+    limit = profiler->nodes.count < 20 ? profiler->nodes.count : 20;
+    fprintf(out, "\nHot AST nodes (top %d):\n", limit);
+    fprintf(out, "  %10s %10s %10s %8s  %s\n", "evals", "self(ms)", "total(ms)", "total%", "node");
+    sorted = sorted_entries(&profiler->nodes);
+    for (int i = 0; i < limit; i++) {
+        node_label(label, sizeof(label), sorted[i].node);
+        fprintf(out, "  %10ld %10.3f %10.3f %7.1f%%  %s\n", sorted[i].evaluations, sorted[i].self_ns / 1e6,
+                sorted[i].total_ns / 1e6, 100.0 * sorted[i].total_ns / percent_base, label);
+    }
+    free(sorted);
+}
+
+void profiler_write_folded(Profiler* profiler, FILE* out) {
+    for (int i = 0; i < profiler->stack_capacity; i++) {
+        if (profiler->stacks[i].stack && profiler->stacks[i].ns > 0)
+            fprintf(out, "%s %lld\n", profiler->stacks[i].stack, profiler->stacks[i].ns);
+    }
+}
+
+void profiler_free(Profiler* profiler) {
+    for (int i = 0; i < profiler->stack_capacity; i++)
+        free(profiler->stacks[i].stack);
+    free(profiler->stacks);
+    free(profiler->statements.entries);
+    free(profiler->nodes.entries);
+    free(profiler->scratch);
+    profiler->stacks = NULL;
+    profiler->scratch = NULL;
+    profiler->statements.entries = NULL;
+    profiler->nodes.entries = NULL;
+}
@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/scheduler.h"
+
+/*
+ * Cooperative time-sliced scheduler.
+ * Worker threads repeatedly take the first script of the run queue, run it for one
+ * time slice outside the lock, and then either put it back at the end of the queue
+ * or mark it as finished.
+ */
+
+// Appends a script to the end of the run queue (lock must be held)
+static void enqueue(Scheduler* sched, Script* script) {
+    script->next = NULL;
+    script->stats.state = SCRIPT_QUEUED;
+    if (sched->queue_tail)
+        sched->queue_tail->next = script;
+    else
+        sched->queue_head = script;
+    sched->queue_tail = script;
+}
+
+// Removes and returns the first script of the run queue (lock must be held)
+static Script* dequeue(Scheduler* sched) {
+    Script* script = sched->queue_head;
+    if (script) {
+        sched->queue_head = script->next;
+        if (!sched->queue_head) sched->queue_tail = NULL;
+        script->next = NULL;
+    }
+    return script;
+}
+
+/*
+ * Runs one time slice of a script and returns the state it should move to.
+ * The memory used at the end of the slice is stored in *memory.
+ * Called without holding the lock: a script is only ever owned by one worker at a time,
+ * but its statistics may be read by sched_get_stats(), so they are not touched here.
+ */
+static ScriptState run_slice(Scheduler* sched, Script* script, size_t* memory) {
+    long slice = script->limits.slice_steps > 0 ? script->limits.slice_steps : sched->default_slice;
+
+    // Never run past the step budget
+    if (script->limits.max_steps > 0) {
+        long remaining = script->limits.max_steps - script->ctx.steps;
+        if (remaining <= 0) {
+            *memory = exec_memory_usage(&script->ctx);
+            return SCRIPT_STEP_LIMIT;
+        }
+        if (slice <= 0 || slice > remaining) slice = remaining;
+    }
+
+    ExecStatus status = exec_run(&script->ctx, slice);
+
+    *memory = exec_memory_usage(&script->ctx);
+
+    switch (status) {
+        case EXEC_DONE:
+            return SCRIPT_DONE;
+        case EXEC_ERROR:
+            return SCRIPT_FAILED;
+        case EXEC_OUT_OF_MEMORY:
+            return SCRIPT_MEMORY_LIMIT;
+        default:
+            if (script->limits.max_steps > 0 && script->ctx.steps >= script->limits.max_steps)
+                return SCRIPT_STEP_LIMIT;
+            return SCRIPT_QUEUED;
+    }
+}
+
+// Main loop of a worker thread
+static void* worker_main(void* arg) {
+    Scheduler* sched = (Scheduler*)arg;
+
+    pthread_mutex_lock(&sched->lock);
+    for (;;) {
+        while (!sched->queue_head && !sched->shutting_down)
+            pthread_cond_wait(&sched->work_ready, &sched->lock);
+        if (sched->shutting_down) break;
+
+        Script* script = dequeue(sched);
+        script->stats.state = SCRIPT_RUNNING;
+        pthread_mutex_unlock(&sched->lock);
+
+        size_t memory = 0;
+        ScriptState next = run_slice(sched, script, &memory);
+
+        pthread_mutex_lock(&sched->lock);
+        script->stats.steps = script->ctx.steps;
+        script->stats.slices++;
+        if (memory > script->stats.peak_memory) script->stats.peak_memory = memory;
+        if (next == SCRIPT_QUEUED) {
+            enqueue(sched, script);
+        } else {
+            // The script is finished: record why and release its evaluation stacks and variables
+            script->stats.state = next;
+            if (next == SCRIPT_STEP_LIMIT)
+                strcpy(script->stats.error, "step budget exceeded");
+            else if (next != SCRIPT_DONE)
+                strcpy(script->stats.error, script->ctx.error);
+            exec_free(&script->ctx);
+            free_symbol_table(&script->table);
+            sched->unfinished--;
+            if (sched->unfinished == 0)
+                pthread_cond_broadcast(&sched->all_done);
+        }
+    }
+    pthread_mutex_unlock(&sched->lock);
+    return NULL;
+}
+
+int sched_init(Scheduler* sched, int worker_count, long default_slice) {
+    if (worker_count <= 0) return -1;
+
+    sched->worker_count = 0;
+    sched->default_slice = default_slice > 0 ? default_slice : 1000;
+    sched->queue_head = sched->queue_tail = NULL;
+    sched->scripts = NULL;
+    sched->script_count = 0;
+    sched->script_capacity = 0;
+    sched->unfinished = 0;
+    sched->shutting_down = 0;
+    pthread_mutex_init(&sched->lock, NULL);
+    pthread_cond_init(&sched->work_ready, NULL);
+    pthread_cond_init(&sched->all_done, NULL);
+
+    sched->workers = malloc(worker_count * sizeof(pthread_t));
+    if (!sched->workers) return -1;
+
+    for (int i = 0; i < worker_count; i++) {
+        if (pthread_create(&sched->workers[i], NULL, worker_main, sched) != 0) {
+            sched_destroy(sched);
+            return -1;
+        }
+        sched->worker_count++;
+    }
+    return 0;
+}
+
+int sched_submit(Scheduler* sched, ASTNode* root, const ScriptLimits* limits, FILE* out) {
+    // Typing changes the AST, which may be shared between scripts and threads: callers do it once, up front
+    if (root != NULL && !root->typed) return -1;
+
+    Script* script = malloc(sizeof(Script));
+    if (!script) return -1;
+
+    init_symbol_table(&script->table);
+    exec_init(&script->ctx, root, &script->table, out);
+    if (limits) {
+        script->limits = *limits;
+    } else {
+        script->limits.max_steps = 0;
+        script->limits.max_memory = 0;
+        script->limits.slice_steps = 0;
+    }
+    script->ctx.memory_limit = script->limits.max_memory;
+    memset(&script->stats, 0, sizeof(script->stats));
+
+    pthread_mutex_lock(&sched->lock);
+    if (sched->script_count == sched->script_capacity) {
+        int capacity = sched->script_capacity ? sched->script_capacity * 2 : 64;
+        Script** scripts = realloc(sched->scripts, capacity * sizeof(Script*));
+        if (!scripts) {
+            pthread_mutex_unlock(&sched->lock);
+            free(script);
+            return -1;
+        }
+        sched->scripts = scripts;
+        sched->script_capacity = capacity;
+    }
+    script->stats.id = sched->script_count;
+    sched->scripts[sched->script_count++] = script;
+    sched->unfinished++;
+    enqueue(sched, script);
+    pthread_cond_signal(&sched->work_ready);
+    pthread_mutex_unlock(&sched->lock);
+
+    return script->stats.id;
+}
+
+void sched_wait(Scheduler* sched) {
+    pthread_mutex_lock(&sched->lock);
+    while (sched->unfinished > 0)
+        pthread_cond_wait(&sched->all_done, &sched->lock);
+    pthread_mutex_unlock(&sched->lock);
+}
+
+int sched_get_stats(Scheduler* sched, int id, ScriptStats* stats) {
+    int result = -1;
+    pthread_mutex_lock(&sched->lock);
+    if (id >= 0 && id < sched->script_count) {
+        *stats = sched->scripts[id]->stats;
+        result = 0;
+    }
+    pthread_mutex_unlock(&sched->lock);
+    return result;
+}
+
+void sched_destroy(Scheduler* sched) {
+    pthread_mutex_lock(&sched->lock);
+    sched->shutting_down = 1;
+    pthread_cond_broadcast(&sched->work_ready);
+    pthread_mutex_unlock(&sched->lock);
+
+    for (int i = 0; i < sched->worker_count; i++)
+        pthread_join(sched->workers[i], NULL);
+    free(sched->workers);
+    sched->workers = NULL;
+    sched->worker_count = 0;
+
+    for (int i = 0; i < sched->script_count; i++) {
+        exec_free(&sched->scripts[i]->ctx);
+        free_symbol_table(&sched->scripts[i]->table);
+        free(sched->scripts[i]);
+    }
+    free(sched->scripts);
+    sched->scripts = NULL;
+    sched->script_count = 0;
+
+    pthread_mutex_destroy(&sched->lock);
+    pthread_cond_destroy(&sched->work_ready);
+    pthread_cond_destroy(&sched->all_done);
+}
@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/snapshot.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*
+ * Saving writes the header, the raw Symbol array and a hash index of the names.
+ * Loading maps the file read-only: the symbol table uses the mapped symbols and
+ * index directly as its base layer, so nothing is parsed, copied or rehashed.
+ */
+
+/*
+ * Collects every variable of 'table' (base layer and program's own layer) into one array.
+ * A variable of the program's own layer replaces the base variable with the same name.
+ * Returns the number of symbols stored in *out (the caller frees it), or -1 on failure.
+ */
+static int merge_layers(const SymbolTable* table, Symbol** out) {
+    int total = table->base_count + table->count;
+    Symbol* merged = malloc((total > 0 ? total : 1) * sizeof(Symbol));
+    if (!merged) return -1;
+
+    if (table->base_count > 0) memcpy(merged, table->base, table->base_count * sizeof(Symbol));
+    int n = table->base_count;
+    // Base names were never checked as a whole (see find_base_symbol()): terminate them before hashing
+    for (int i = 0; i < n; i++) merged[i].name[sizeof(merged[i].name) - 1] = '\0';
+    for (int i = 0; i < table->count; i++) {
+        const Symbol* hidden = find_base_symbol(table, table->symbols[i].name);
+        if (hidden != NULL)
+            merged[hidden - table->base] = table->symbols[i];
+        else
+            merged[n++] = table->symbols[i];
+    }
+
+    *out = merged;
+    return n;
+}
+
+/*
+ * Builds the hash index of 'symbols': at least twice as many slots as symbols,
+ * so lookups stay short and there is always an empty slot to stop on.
+ */
+static unsigned int* build_index(const Symbol* symbols, int count, unsigned int* index_size) {
+    unsigned int size = 8;
+    while (size < (unsigned int)count * 2) size *= 2;
+
+    unsigned int* index = calloc(size, sizeof(unsigned int));
+    if (!index) return NULL;
+    for (int i = 0; i < count; i++) {
+        unsigned int slot = symbol_hash(symbols[i].name) & (size - 1);
+        while (index[slot] != 0) slot = (slot + 1) & (size - 1);
+        index[slot] = (unsigned int)i + 1;
+    }
+
+    *index_size = size;
+    return index;
+}
+
+int snapshot_save(const char* path, const SymbolTable* table) {
+    Symbol* symbols;
+    int count = merge_layers(table, &symbols);
+    unsigned int index_size = 0;
+    unsigned int* index = count >= 0 ? build_index(symbols, count, &index_size) : NULL;
+    if (!index) {
+        fprintf(stderr, "Error: out of memory while saving snapshot\n");
+        if (count >= 0) free(symbols);
+        return -1;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        perror("Error opening snapshot file");
+        free(symbols);
+        free(index);
+        return -1;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    strcpy(header.magic, SNAPSHOT_MAGIC);
+    header.version = SNAPSHOT_VERSION;
+    header.symbol_size = sizeof(Symbol);
+    header.count = (unsigned int)count;
+    header.index_size = index_size;
+
+    int failed = fwrite(&header, sizeof(header), 1, file) != 1 ||
+                 (count > 0 && fwrite(symbols, sizeof(Symbol), count, file) != (size_t)count) ||
+                 fwrite(index, sizeof(unsigned int), index_size, file) != index_size;
+    free(symbols);
+    free(index);
+
+    if (fclose(file) != 0) failed = 1;
+    if (failed) {
+        perror("Error writing snapshot file");
+        return -1;
+    }
+    return count;
+}
+
+#ifndef _WIN32
+// Maps the whole file into memory (read-only: the symbol table never writes to its base layer)
+static int map_file(const char* path, Snapshot* snapshot) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("Error opening snapshot file");
+        return -1;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        fprintf(stderr, "Error: snapshot file '%s' is empty or unreadable\n", path);
+        close(fd);
+        return -1;
+    }
+
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping stays valid after the descriptor is closed
+    if (data == MAP_FAILED) {
+        perror("Error mapping snapshot file");
+        return -1;
+    }
+
+    snapshot->data = data;
+    snapshot->size = (size_t)info.st_size;
+    return 0;
+}
+#else
+// Windows has no mmap(): read the whole file into memory instead
+static int map_file(const char* path, Snapshot* snapshot) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror("Error opening snapshot file");
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    rewind(file);
+
+    void* data = length > 0 ? malloc(length) : NULL;
+    if (!data || fread(data, 1, length, file) != (size_t)length) {
+        fprintf(stderr, "Error: cannot read snapshot file '%s'\n", path);
+        free(data);
+        fclose(file);
+        return -1;
+    }
+
+    fclose(file);
+    snapshot->data = data;
+    snapshot->size = (size_t)length;
+    return 0;
+}
+#endif
+
+int snapshot_load(const char* path, Snapshot* snapshot, SymbolTable* table) {
+    snapshot->data = NULL;
+    snapshot->size = 0;
+    if (map_file(path, snapshot) != 0) return -1;
+
+    // Check that the file was written by a compatible version of the compiler
+    const SnapshotHeader* header = (const SnapshotHeader*)snapshot->data;
+    if (snapshot->size < sizeof(SnapshotHeader) ||
+        memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SNAPSHOT_VERSION ||
+        header->symbol_size != sizeof(Symbol) ||
+        header->index_size == 0 || (header->index_size & (header->index_size - 1)) != 0 ||
+        snapshot->size < sizeof(SnapshotHeader) + (size_t)header->count * sizeof(Symbol)
+                         + (size_t)header->index_size * sizeof(unsigned int)) {
+        fprintf(stderr, "Error: '%s' is not a valid snapshot file for this version\n", path);
+        snapshot_close(snapshot);
+        return -1;
+    }
+
+    /*
+     * The mapped symbols and index become the base layer; the program's own layer starts empty.
+     * Their contents are checked lazily by find_base_symbol(), only for the entries a program uses.
+     */
+    const char* symbols = (const char*)snapshot->data + sizeof(SnapshotHeader);
+    const unsigned int* index = (const unsigned int*)(symbols + (size_t)header->count * sizeof(Symbol));
+
+    init_symbol_table(table);
+    table->base = (const Symbol*)symbols;
+    table->base_count = (int)header->count;
+    table->base_index = index;
+    table->base_index_size = header->index_size;
+    return 0;
+}
+
+void snapshot_close(Snapshot* snapshot) {
+    if (snapshot->data) {
+#ifndef _WIN32
+        munmap(snapshot->data, snapshot->size);
+#else
+        free(snapshot->data);
+#endif
+    }
+    snapshot->data = NULL;
+    snapshot->size = 0;
+}
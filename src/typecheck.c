@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/typecheck.h"
+
+/*
+ * The inference walks the statements in the same order as the interpreter and
+ * keeps track of the type of every variable declared so far.
+ */
+
+/*
+ * All the variables known so far: the ones the program declares, on top of the table
+ * the program starts with. The declared variables are kept in a SymbolTable of their
+ * own (only the types matter there), so both lookups use the same hash indexes.
+ * The initial table is only read, never copied, so a large snapshot costs nothing here.
+ */
+typedef struct {
+    SymbolTable declared;       // variables assigned by the program (values unused)
+    const SymbolTable* initial; // may be NULL
+} TypeEnv;
+
+/*
+ * Finds the type of a variable: first among the program's own declarations,
+ * then in the initial table (its own symbols, then its snapshot).
+ * Returns 1 and sets *type if found, 0 otherwise.
+ */
+static int find_var(const TypeEnv* env, const char* name, ValueType* type) {
+    const Symbol* symbol = find_symbol_entry(&env->declared, name);
+    if (symbol == NULL && env->initial != NULL)
+        symbol = find_symbol_entry(env->initial, name);
+    if (symbol == NULL) return 0;
+    *type = symbol->type;
+    return 1;
+}
+
+static void declare_var(TypeEnv* env, const char* name, ValueType type) {
+    Value unused;
+    unused.i = 0;
+    if (!try_set_symbol(&env->declared, name, type, unused)) {
+        printf("Type error: out of memory\n");
+        exit(1);
+    }
+}
+
+/*
+ * Turns 'node' into an AST_CAST to 'target' whose child is a copy of the original node.
+ * The conversion is made in place, so whatever pointed to 'node' (a parent, or the
+ * previous statement of the list) now points to the conversion.
+ * The 'right' pointer is left untouched because it may link the next statement.
+ */
+static void convert_in_place(ASTNode* node, ValueType target) {
+    ASTNode* operand = malloc(sizeof(ASTNode));
+    if (!operand) {
+        printf("Type error: out of memory\n");
+        exit(1);
+    }
+    *operand = *node;
+
+    node->type = AST_CAST;
+    node->vtype = target;
+    node->value = 0;
+    node->fvalue = 0.0;
+    node->name[0] = '\0';
+    node->left = operand;
+}
+
+/*
+ * Infers the type of an expression, converting operands where needed, and returns it.
+ */
+static ValueType infer_expression(ASTNode* node, TypeEnv* env) {
+    node->typed = 1;
+    switch (node->type) {
+        case AST_NUMBER:
+            // The parser already knows the type of a literal (2 is int, 2.5 is double)
+            return node->vtype;
+
+        case AST_VAR: {
+            // An unknown variable is left as int: the interpreter reports it as undefined when it is reached
+            ValueType type;
+            node->vtype = find_var(env, node->name, &type) ? type : TYPE_INT;
+            return node->vtype;
+        }
+
+        case AST_BINARY_OP: {
+            ValueType left = infer_expression(node->left, env);
+            ValueType right = infer_expression(node->right, env);
+            if (left == right) {
+                node->vtype = left;
+            } else {
+                // Mixed int and double: the operation is done in double
+                node->vtype = TYPE_DOUBLE;
+                if (left != TYPE_DOUBLE) convert_in_place(node->left, TYPE_DOUBLE);
+                if (right != TYPE_DOUBLE) convert_in_place(node->right, TYPE_DOUBLE);
+            }
+            return node->vtype;
+        }
+
+        case AST_CAST: {
+            ValueType operand = infer_expression(node->left, env);
+            if (operand == node->vtype && node->right == NULL) {
+                // The value already has the requested type (e.g. "let x: int = 5;"): drop the conversion
+                ASTNode* child = node->left;
+                *node = *child;
+                free(child);
+            }
+            return node->vtype;
+        }
+
+        default:
+            return node->vtype;
+    }
+}
+
+static void infer_statement(ASTNode* node, TypeEnv* env) {
+    node->typed = 1;
+    switch (node->type) {
+        case AST_ASSIGN: {
+            // Before inference, an AST_CAST under an assignment can only come from an annotation ("let x: int = ...")
+            ASTNode* annotation = node->left->type == AST_CAST ? node->left : NULL;
+            ValueType annotated = annotation ? annotation->vtype : TYPE_INT;
+            int line = annotation ? annotation->line : 0;
+            int column = annotation ? annotation->column : 0;
+
+            ValueType type = infer_expression(node->left, env);
+            ValueType declared;
+            if (!find_var(env, node->name, &declared)) {
+                declare_var(env, node->name, type); // first assignment: declares the variable
+            } else if (annotation != NULL && annotated != declared) {
+                // A variable keeps its type: an annotation cannot change it
+                printf("Type error: variable '%s' is %s and cannot be redeclared as %s at line %d, column %d\n",
+                       node->name, value_type_name(declared), value_type_name(annotated), line, column);
+                exit(1);
+            } else if (declared != type) {
+                convert_in_place(node->left, declared); // later assignments keep the variable's type
+            }
+            node->vtype = node->left->vtype;
+            break;
+        }
+
+        case AST_PRINT:
+            node->vtype = infer_expression(node->left, env);
+            break;
+
+        default:
+            // Standalone expression (e.g. "x + 1;")
+            infer_expression(node, env);
+            break;
+    }
+}
+
+void infer_types(ASTNode* root, const SymbolTable* initial) {
+    // Variables that already exist before the program starts are looked up in 'initial' directly
+    TypeEnv env;
+    init_symbol_table(&env.declared);
+    env.initial = initial;
+
+    // Same traversal as the interpreter: statements are linked through 'right'
+    for (ASTNode* node = root; node != NULL; node = node->right)
+        infer_statement(node, &env);
+
+    free_symbol_table(&env.declared);
+}